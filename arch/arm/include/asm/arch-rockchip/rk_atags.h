@@ -20,6 +20,7 @@
 #define ATAG_PUB_KEY		0x54410056
 #define ATAG_SOC_INFO		0x54410057
 #define ATAG_BOOT1_PARAM	0x54410058
+#define ATAG_MTD_BLK_MAP	0x54410059
 #define ATAG_MAX		0x544100ff
 
 /* Tag size and offset */
@@ -73,6 +74,10 @@
  */
 #define B1P2_BOOT_CPU_MASK	0x00000fff
 
+/* tag_mtd_blk_map array size */
+#define MTD_BLK_MAP_RANGE_MAX	32
+#define MTD_BLK_MAP_BAD_MAX	64
+
 /* tag_ddr_mem.flags */
 #define DDR_MEM_FLG_EXT_TOP	1
 
@@ -175,6 +180,26 @@ struct tag_boot1p {
 	u32 hash;
 } __packed;
 
+/*
+ * Bad block status of the mtd_blk ranges scanned by SPL. Every block inside
+ * range[] has been checked, and the bad ones are listed in bad[].
+ */
+struct tag_mtd_blk_map {
+	u32 version;
+	u32 devnum;
+	u32 erasesize_shift;
+	u32 blk_total;
+	u32 range_cnt;
+	struct {
+		u32 begin;
+		u32 cnt;
+	} range[MTD_BLK_MAP_RANGE_MAX];
+	u32 bad_cnt;
+	u32 bad[MTD_BLK_MAP_BAD_MAX];
+	u32 reserved[4];
+	u32 hash;
+} __packed;
+
 struct tag_core {
 	u32 flags;
 	u32 pagesize;
@@ -200,6 +225,7 @@ struct tag {
 		struct tag_pub_key	pub_key;
 		struct tag_soc_info	soc;
 		struct tag_boot1p	boot1p;
+		struct tag_mtd_blk_map	mtd_blk_map;
 	} u;
 } __aligned(4);
 
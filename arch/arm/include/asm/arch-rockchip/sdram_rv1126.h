@@ -373,6 +373,28 @@ struct rv1126_fsp_param {
 
 /* store result of read and write training, for ddr_dq_eye tool in u-boot */
 #define RW_TRN_RESULT_ADDR	(0x2000000 + 0x8000)	/* 32M + 32k */
+
+/* trained phy deskew cached across warm reset */
+#define TRN_CACHE_FLAG		(0xfead0c01)
+#define TRN_CACHE_CA_NUM	(0x20)
+#define TRN_CACHE_GRP_NUM	(0x2c)
+
+struct rv1126_trn_cache_fsp {
+	u32 freq_mhz;
+	u8 ca_deskew[TRN_CACHE_CA_NUM];
+	u8 dq_deskew[4][TRN_CACHE_GRP_NUM];
+	u8 wrlvl[4];
+};
+
+struct rv1126_trn_cache {
+	u32 flag;
+	u32 size;
+	u32 dramtype;
+	u32 params;
+	struct sdram_cap_info cap_info;
+	struct rv1126_trn_cache_fsp fsp[MAX_IDX];
+	u32 checksum;
+};
 #define PRINT_STEP		1
 
 #undef FSP_NUM
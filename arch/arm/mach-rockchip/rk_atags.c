@@ -181,6 +181,7 @@ int atags_set_tag(u32 magic, void *tagdata)
 {
 	u32 length, size = 0, hash;
 	struct tag *t = (struct tag *)ATAGS_PHYS_BASE;
+	bool replace = false;
 
 #if !defined(CONFIG_TPL_BUILD) && !defined(CONFIG_FPGA_ROCKCHIP)
 	if (!atags_is_available())
@@ -216,8 +217,10 @@ int atags_set_tag(u32 magic, void *tagdata)
 				return -EINVAL;
 
 			/* This is an old tag, override it */
-			if (t->hdr.magic == magic)
+			if (t->hdr.magic == magic) {
+				replace = true;
 				break;
+			}
 
 			if (t->hdr.magic == ATAG_NONE)
 				break;
@@ -253,12 +256,22 @@ int atags_set_tag(u32 magic, void *tagdata)
 	case ATAG_BOOT1_PARAM:
 		size = tag_size(tag_boot1p);
 		break;
+	case ATAG_MTD_BLK_MAP:
+		size = tag_size(tag_mtd_blk_map);
+		break;
 	};
 
 	if (!size)
 		return -EINVAL;
 
-	if (atags_size_overflow(t, size))
+	/*
+	 * An old tag of the same size is rewritten in place and keeps the
+	 * tags after it, otherwise the list ends with the new tag.
+	 */
+	if (replace && t->hdr.size != size)
+		replace = false;
+
+	if (!replace && atags_size_overflow(t, size))
 		return -ENOMEM;
 
 	/* It's okay to setup a new tag */
@@ -269,6 +282,9 @@ int atags_set_tag(u32 magic, void *tagdata)
 	hash = js_hash(t, (size << 2) - HASH_LEN);
 	memcpy((char *)&t->u + length, &hash, HASH_LEN);
 
+	if (replace)
+		return 0;
+
 	/* Next tag */
 	t = tag_next(t);
 
@@ -164,6 +164,25 @@ static void atags_print_tag(struct tag *t)
 			printf("    res[%d] = 0x%x\n", i, t->u.boot1p.reserved[i]);
 		printf("      hash = 0x%x\n", t->u.boot1p.hash);
 		break;
+	case ATAG_MTD_BLK_MAP:
+		printf("[mtd_blk_map]:\n");
+		printf("     magic = 0x%x\n", t->hdr.magic);
+		printf("      size = 0x%x\n\n", t->hdr.size << 2);
+		printf("   version = 0x%x\n", t->u.mtd_blk_map.version);
+		printf("    devnum = 0x%x\n", t->u.mtd_blk_map.devnum);
+		printf("  blkshift = 0x%x\n", t->u.mtd_blk_map.erasesize_shift);
+		printf(" blk_total = 0x%x\n", t->u.mtd_blk_map.blk_total);
+		for (i = 0; i < t->u.mtd_blk_map.range_cnt &&
+		     i < MTD_BLK_MAP_RANGE_MAX; i++)
+			printf("  range[%d] = 0x%x + 0x%x\n", i,
+			       t->u.mtd_blk_map.range[i].begin,
+			       t->u.mtd_blk_map.range[i].cnt);
+		for (i = 0; i < t->u.mtd_blk_map.bad_cnt &&
+		     i < MTD_BLK_MAP_BAD_MAX; i++)
+			printf("    bad[%d] = 0x%x\n", i,
+			       t->u.mtd_blk_map.bad[i]);
+		printf("      hash = 0x%x\n", t->u.mtd_blk_map.hash);
+		break;
 	case ATAG_CORE:
 		printf("[core]:\n");
 		printf("     magic = 0x%x\n", t->hdr.magic);
@@ -8,10 +8,32 @@
 #include <common.h>
 #include <command.h>
 #include <dm.h>
+#include <div64.h>
 #include <nvme.h>
 
 static int nvme_curr_dev;
 
+static int nvme_bench(ulong addr, lbaint_t blk, lbaint_t cnt)
+{
+	struct blk_desc *desc;
+	ulong start, ms, n;
+	u64 bytes;
+
+	desc = blk_get_devnum_by_type(IF_TYPE_NVME, nvme_curr_dev);
+	if (!desc)
+		return CMD_RET_FAILURE;
+
+	start = get_timer(0);
+	n = blk_dread(desc, blk, cnt, (void *)addr);
+	ms = max(get_timer(start), 1UL);
+
+	bytes = (u64)n << desc->log2blksz;
+	printf("%llu bytes read in %lu ms (%llu KiB/s)\n", bytes, ms,
+	       lldiv((bytes >> 10) * 1000, ms));
+
+	return n == cnt ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
+}
+
 static int do_nvme(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	int ret;
@@ -38,6 +60,11 @@ static int do_nvme(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		}
 	}
 
+	if (argc == 5 && strncmp(argv[1], "bench", 5) == 0)
+		return nvme_bench(simple_strtoul(argv[2], NULL, 16),
+				  simple_strtoul(argv[3], NULL, 16),
+				  simple_strtoul(argv[4], NULL, 16));
+
 	return blk_common_cmd(argc, argv, IF_TYPE_NVME, &nvme_curr_dev);
 }
 
@@ -52,5 +79,7 @@ U_BOOT_CMD(
 	"nvme read addr blk# cnt - read `cnt' blocks starting at block\n"
 	"     `blk#' to memory address `addr'\n"
 	"nvme write addr blk# cnt - write `cnt' blocks starting at block\n"
-	"     `blk#' from memory address `addr'"
+	"     `blk#' from memory address `addr'\n"
+	"nvme bench addr blk# cnt - time a sequential read of `cnt' blocks\n"
+	"     starting at block `blk#' to memory address `addr'"
 );
@@ -466,7 +466,7 @@ static AvbSlotVerifyResult android_slot_verify(char *boot_partname,
 			       unsigned long *android_load_address,
 			       char *slot_suffix)
 {
-	const char *requested_partitions[1] = {NULL};
+	const char *requested_partitions[3] = {NULL};
 	uint8_t unlocked = true;
 	AvbOps *ops;
 	AvbSlotVerifyFlags flags;
@@ -479,6 +479,8 @@ static AvbSlotVerifyResult android_slot_verify(char *boot_partname,
 	char retry_no_vbmeta_partition = 1;
 	unsigned long load_address = *android_load_address;
 	struct andr_img_hdr *hdr;
+	size_t i;
+	int ret;
 
 	requested_partitions[0] = boot_partname;
 	ops = avb_ops_user_new();
@@ -512,6 +514,26 @@ static AvbSlotVerifyResult android_slot_verify(char *boot_partname,
 	if (strcmp(boot_partname, "recovery") == 0)
 		flags |= AVB_SLOT_VERIFY_FLAGS_NO_VBMETA_PARTITION;
 
+	/*
+	 * Have AVB load and hash vendor_boot together with boot, so that
+	 * the vendor ramdisk is taken from the verified copy in memory
+	 * rather than read from storage a second time.
+	 *
+	 * Not when verification errors are allowed: boot is then preloaded
+	 * by android_image_load_by_partname() which reads vendor_boot itself.
+	 */
+	if (!strcmp(boot_partname, ANDROID_PARTITION_BOOT) &&
+	    !(flags & AVB_SLOT_VERIFY_FLAGS_ALLOW_VERIFICATION_ERROR)) {
+		struct blk_desc *dev_desc = rockchip_get_bootdev();
+		disk_partition_t part;
+
+		if (dev_desc &&
+		    part_get_info_by_name(dev_desc,
+					  ANDROID_PARTITION_VENDOR_BOOT,
+					  &part) >= 0)
+			requested_partitions[1] = ANDROID_PARTITION_VENDOR_BOOT;
+	}
+
 retry_verify:
 	verify_result =
 	avb_slot_verify(ops,
@@ -597,7 +619,23 @@ retry_verify:
 			strcat(newbootargs, slot_data[0]->cmdline);
 		env_set("bootargs", newbootargs);
 
-		hdr = (void *)slot_data[0]->loaded_partitions->data;
+		/*
+		 * The loaded partitions are in vbmeta descriptor order, not
+		 * in requested order: register them all and look boot up.
+		 */
+		for (i = 0; i < slot_data[0]->num_loaded_partitions; i++) {
+			AvbPartitionData *p = &slot_data[0]->loaded_partitions[i];
+
+			android_image_preload_add(p->partition_name,
+						  p->data, p->data_size);
+		}
+
+		hdr = android_image_preload_get(boot_partname, NULL);
+		if (!hdr) {
+			printf("No %s image loaded by AVB\n", boot_partname);
+			verify_result = AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+			goto out;
+		}
 
 		/*
 		 *		populate boot_img_hdr_v34
@@ -633,7 +671,9 @@ retry_verify:
 
 		/* Reserve page_size */
 		load_address -= hdr->page_size;
-		if (android_image_memcpy_separate(hdr, &load_address)) {
+		ret = android_image_memcpy_separate(hdr, &load_address);
+		if (ret) {
+			android_image_preload_clear();
 			printf("Failed to separate copy android image\n");
 			return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
 		}
@@ -649,8 +689,10 @@ out:
 		verify_result = AVB_SLOT_VERIFY_RESULT_ERROR_IO;
 	}
 
-	if (slot_data[0] != NULL)
+	if (slot_data[0] != NULL) {
+		android_image_preload_clear();
 		avb_slot_verify_data_free(slot_data[0]);
+	}
 
 	if ((unlocked & LOCK_MASK) && can_boot)
 		return 0;
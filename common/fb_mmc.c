@@ -14,6 +14,7 @@
 #include <mmc.h>
 #include <div64.h>
 #include <linux/compat.h>
+#include <linux/log2.h>
 #include <android_image.h>
 #ifdef CONFIG_RKIMG_BOOTLOADER
 #include <boot_rkimg.h>
@@ -100,6 +101,56 @@ static lbaint_t fb_mmc_sparse_reserve(struct sparse_storage *info,
 	return blkcnt;
 }
 
+static lbaint_t fb_mmc_sparse_erase(struct sparse_storage *info,
+		lbaint_t blk, lbaint_t blkcnt)
+{
+	struct fb_mmc_sparse *sparse = info->priv;
+	lbaint_t step = max_t(lbaint_t, info->erase_grp, FASTBOOT_MAX_BLK_WRITE);
+	lbaint_t cur_blkcnt;
+	lbaint_t i;
+
+	/* Both are powers of two, so every step stays group aligned */
+	for (i = 0; i < blkcnt; i += cur_blkcnt) {
+		cur_blkcnt = min(blkcnt - i, step);
+		timed_send_info(&timer, "erasing");
+		if (blk_derase(sparse->dev_desc, blk + i, cur_blkcnt) !=
+		    cur_blkcnt)
+			return i;
+	}
+
+	return blkcnt;
+}
+
+/*
+ * Zero FILL chunks can be erased instead of written when the eMMC reads
+ * erased blocks back as zeroes. With TRIM any block range can be erased,
+ * otherwise only whole erase groups.
+ */
+static void fb_mmc_sparse_setup_erase(struct blk_desc *dev_desc,
+				      struct sparse_storage *sparse)
+{
+	struct mmc *mmc;
+
+	sparse->erase = NULL;
+	sparse->erase_grp = 0;
+
+	if (dev_desc->if_type != IF_TYPE_MMC)
+		return;
+
+	mmc = find_mmc_device(dev_desc->devnum);
+	if (!mmc || IS_SD(mmc) || mmc->esr.erased_mem_cont)
+		return;
+
+	if (mmc->esr.mmc_can_trim)
+		sparse->erase_grp = 1;
+	else if (mmc->erase_grp_size && is_power_of_2(mmc->erase_grp_size))
+		sparse->erase_grp = mmc->erase_grp_size;
+	else
+		return;
+
+	sparse->erase = fb_mmc_sparse_erase;
+}
+
 static void write_raw_image(struct blk_desc *dev_desc, disk_partition_t *info,
 		const char *part_name, void *buffer,
 		unsigned int download_bytes, char *response)
@@ -387,6 +438,7 @@ void fb_mmc_flash_write(const char *cmd, void *download_buffer,
 		sparse.size = info.size;
 		sparse.write = fb_mmc_sparse_write;
 		sparse.reserve = fb_mmc_sparse_reserve;
+		fb_mmc_sparse_setup_erase(dev_desc, &sparse);
 
 		printf("Flashing sparse image at offset " LBAFU "\n",
 		       sparse.start);
@@ -35,9 +35,68 @@ DECLARE_GLOBAL_DATA_PTR;
 #define BLK_CNT(_num_bytes, _block_size)	\
 		((_num_bytes + _block_size - 1) / _block_size)
 
+#define ANDROID_PRELOAD_MAX			4
+
 static char andr_tmp_str[ANDR_BOOT_ARGS_SIZE + 1];
 static u32 android_kernel_comp_type = IH_COMP_NONE;
 
+/*
+ * Partitions which are already fully in memory, eg. loaded and hashed by
+ * AVB, so that image_load() takes the sub-images from there instead of
+ * reading the storage again.
+ */
+static struct {
+	char name[32];
+	void *addr;
+	ulong size;
+} android_preloads[ANDROID_PRELOAD_MAX];
+
+int android_image_preload_add(const char *part_name, void *addr, ulong size)
+{
+	int i, slot = -1;
+
+	if (!part_name || !*part_name || !addr || strlen(part_name) >= 32)
+		return -EINVAL;
+
+	for (i = 0; i < ANDROID_PRELOAD_MAX; i++) {
+		if (!strcmp(android_preloads[i].name, part_name)) {
+			slot = i;
+			break;
+		}
+		if (slot < 0 && !android_preloads[i].addr)
+			slot = i;
+	}
+	if (slot < 0)
+		return -ENOSPC;
+
+	strcpy(android_preloads[slot].name, part_name);
+	android_preloads[slot].addr = addr;
+	android_preloads[slot].size = size;
+
+	return 0;
+}
+
+void *android_image_preload_get(const char *part_name, ulong *size)
+{
+	int i;
+
+	for (i = 0; i < ANDROID_PRELOAD_MAX; i++) {
+		if (android_preloads[i].addr &&
+		    !strcmp(android_preloads[i].name, part_name)) {
+			if (size)
+				*size = android_preloads[i].size;
+			return android_preloads[i].addr;
+		}
+	}
+
+	return NULL;
+}
+
+void android_image_preload_clear(void)
+{
+	memset(android_preloads, 0, sizeof(android_preloads));
+}
+
 u32 android_image_major_version(void)
 {
 	/* MSB 7-bits */
@@ -317,6 +376,7 @@ static int image_load(img_t img, struct andr_img_hdr *hdr,
 	struct blk_desc *desc = rockchip_get_bootdev();
 	disk_partition_t part_vendor_boot;
 	__maybe_unused u32 sizesz;
+	ulong preload_size = 0;
 	ulong pgsz = hdr->page_size;
 	ulong blksz = desc->blksz;
 	ulong blkcnt, blkoff;
@@ -339,18 +399,29 @@ static int image_load(img_t img, struct andr_img_hdr *hdr,
 			return -ENOMEM;
 		break;
 	case IMG_VENDOR_RAMDISK:
-		if (part_get_info_by_name(desc,
-					  ANDROID_PARTITION_VENDOR_BOOT,
-					  &part_vendor_boot) < 0) {
-			printf("No vendor boot partition\n");
-			return -ENOENT;
-		}
-		/* Always load vendor boot from storage: avb full load boot/recovery */
-		blkstart = part_vendor_boot.start;
-		ram_base = 0;
-
 		pgsz = hdr->vendor_page_size;
 		offset = ALIGN(VENDOR_BOOT_HDR_SIZE, pgsz);
+
+		/*
+		 * ram_base is the boot image, vendor boot is a partition of
+		 * its own: take it from the preloaded copy if AVB has loaded
+		 * one, otherwise load it from storage.
+		 */
+		ram_base = android_image_preload_get(ANDROID_PARTITION_VENDOR_BOOT,
+						     &preload_size);
+		if (ram_base &&
+		    preload_size < offset + hdr->vendor_ramdisk_size)
+			ram_base = 0;
+		if (!ram_base) {
+			if (part_get_info_by_name(desc,
+						  ANDROID_PARTITION_VENDOR_BOOT,
+						  &part_vendor_boot) < 0) {
+				printf("No vendor boot partition\n");
+				return -ENOENT;
+			}
+			blkstart = part_vendor_boot.start;
+		}
+
 		blkcnt = DIV_ROUND_UP(hdr->vendor_ramdisk_size, blksz);
 		ramdst = (void *)env_get_ulong("ramdisk_addr_r", 16, 0);
 		datasz = hdr->vendor_ramdisk_size;
@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Decryption of ciphered FIT image data
+ *
+ * An image node may carry a "cipher" subnode:
+ *
+ *	cipher {
+ *		algo = "aes128";		(aes192, aes256, aes128-xts,
+ *						 aes256-xts)
+ *		key-name-hint = "dev";
+ *		iv = [...];			(optional, 16 bytes)
+ *	};
+ *
+ * The key is never part of the FIT. It is taken from the "key" property of
+ * /cipher/key-<algo>-<key-name-hint> in the control FDT, which also holds
+ * the iv when the FIT does not. The "aes" algos are CBC; xts keys hold
+ * the data key followed by the tweak key. The image hashes and signature
+ * cover the ciphered data, and "data-size-unciphered" in the image node
+ * gives the plain size once the padding is dropped.
+ */
+
+#include <common.h>
+#include <crypto.h>
+#include <errno.h>
+#include <image.h>
+#include <malloc.h>
+#include <uboot_aes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define FIT_CIPHER_BLOCK_SIZE	16
+
+/* Bounds a single engine job well below its completion timeout */
+#define FIT_CIPHER_CHUNK_SIZE	(4 * 1024 * 1024)
+
+struct fit_cipher_algo {
+	const char *name;
+	u32 mode;
+	u32 key_len;	/* bytes of key material in the control FDT */
+};
+
+static const struct fit_cipher_algo fit_cipher_algos[] = {
+	{ "aes128",	RK_MODE_CBC, 16 },
+	{ "aes192",	RK_MODE_CBC, 24 },
+	{ "aes256",	RK_MODE_CBC, 32 },
+	{ "aes128-xts",	RK_MODE_XTS, 32 },
+	{ "aes256-xts",	RK_MODE_XTS, 64 },
+};
+
+static const struct fit_cipher_algo *fit_cipher_get_algo(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(fit_cipher_algos); i++) {
+		if (!strcmp(fit_cipher_algos[i].name, name))
+			return &fit_cipher_algos[i];
+	}
+
+	return NULL;
+}
+
+#if CONFIG_IS_ENABLED(DM_CRYPTO)
+static int fit_cipher_decrypt_hw(const struct fit_cipher_algo *algo,
+				 const u8 *key, const u8 *iv,
+				 u8 *data, size_t len)
+{
+	u8 chain[FIT_CIPHER_BLOCK_SIZE];
+	cipher_context ctx;
+	struct udevice *dev;
+	size_t chunk;
+	int ret;
+
+	dev = crypto_get_device(CRYPTO_AES);
+	if (!dev)
+		return -ENODEV;
+
+	memset(&ctx, 0x00, sizeof(ctx));
+	ctx.algo = CRYPTO_AES;
+	ctx.mode = algo->mode;
+	ctx.key = key;
+	ctx.iv = chain;
+	ctx.iv_len = FIT_CIPHER_BLOCK_SIZE;
+
+	if (algo->mode == RK_MODE_XTS) {
+		/* the tweak runs over the whole image, so it can't be chunked */
+		if (len > FIT_CIPHER_CHUNK_SIZE)
+			return -EFBIG;
+
+		ctx.key_len = algo->key_len / 2;
+		ctx.twk_key = key + ctx.key_len;
+		memcpy(chain, iv, FIT_CIPHER_BLOCK_SIZE);
+
+		return crypto_cipher(dev, &ctx, data, data, len, false);
+	}
+
+	ctx.key_len = algo->key_len;
+	memcpy(chain, iv, FIT_CIPHER_BLOCK_SIZE);
+
+	while (len) {
+		u8 next[FIT_CIPHER_BLOCK_SIZE];
+
+		chunk = min_t(size_t, len, FIT_CIPHER_CHUNK_SIZE);
+
+		/* the last ciphered block chains into the next chunk */
+		memcpy(next, data + chunk - FIT_CIPHER_BLOCK_SIZE,
+		       FIT_CIPHER_BLOCK_SIZE);
+
+		ret = crypto_cipher(dev, &ctx, data, data, chunk, false);
+		if (ret)
+			return ret;
+
+		memcpy(chain, next, FIT_CIPHER_BLOCK_SIZE);
+		data += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+#endif
+
+#if CONFIG_IS_ENABLED(AES)
+/* lib/aes.c only knows AES-128 and always chains from a zero iv */
+static int fit_cipher_decrypt_sw(const struct fit_cipher_algo *algo,
+				 const u8 *key, const u8 *iv,
+				 u8 *data, size_t len)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 chain[AES_KEY_LENGTH], block[AES_KEY_LENGTH], tmp[AES_KEY_LENGTH];
+
+	if (algo->mode != RK_MODE_CBC || algo->key_len != AES_KEY_LENGTH)
+		return -ENOTSUPP;
+
+	aes_expand_key((u8 *)key, key_exp);
+	memcpy(chain, iv, AES_KEY_LENGTH);
+
+	for (; len; data += AES_KEY_LENGTH, len -= AES_KEY_LENGTH) {
+		memcpy(block, data, AES_KEY_LENGTH);
+		aes_decrypt(block, key_exp, tmp);
+		aes_apply_cbc_chain_data(chain, tmp, data);
+		memcpy(chain, block, AES_KEY_LENGTH);
+	}
+
+	return 0;
+}
+#endif
+
+int fit_image_uncipher(const void *fit, int noffset, void *data,
+		       size_t *size)
+{
+	const struct fit_cipher_algo *algo;
+	const void *blob = gd_fdt_blob();
+	const char *algo_name, *key_name;
+	const fdt32_t *plain;
+	const u8 *key, *iv;
+	char path[64];
+	int cipher_node, key_node, len;
+	size_t plain_size;
+	int ret = -ENOTSUPP;
+
+	cipher_node = fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME);
+	if (cipher_node < 0)
+		return 0;
+
+	algo_name = fdt_getprop(fit, cipher_node, FIT_ALGO_PROP, NULL);
+	key_name = fdt_getprop(fit, cipher_node, FIT_KEY_HINT, NULL);
+	if (!algo_name || !key_name) {
+		printf("Cipher node of '%s' lacks algo or key-name-hint\n",
+		       fit_get_name(fit, noffset, NULL));
+		return -EINVAL;
+	}
+
+	algo = fit_cipher_get_algo(algo_name);
+	if (!algo) {
+		printf("Unsupported cipher '%s'\n", algo_name);
+		return -ENOTSUPP;
+	}
+
+	if (*size % FIT_CIPHER_BLOCK_SIZE)
+		return -EINVAL;
+
+	snprintf(path, sizeof(path), "/%s/key-%s-%s",
+		 FIT_CIPHER_NODENAME, algo_name, key_name);
+	key_node = blob ? fdt_path_offset(blob, path) : -FDT_ERR_NOTFOUND;
+	if (key_node < 0) {
+		printf("Can't find cipher key %s\n", path);
+		return -ENOENT;
+	}
+
+	key = fdt_getprop(blob, key_node, "key", &len);
+	if (!key || len != algo->key_len)
+		return -EINVAL;
+
+	iv = fdt_getprop(fit, cipher_node, "iv", &len);
+	if (!iv)
+		iv = fdt_getprop(blob, key_node, "iv", &len);
+	if (!iv || len != FIT_CIPHER_BLOCK_SIZE)
+		return -EINVAL;
+
+	plain = fdt_getprop(fit, noffset, FIT_DATA_SIZE_UNCIPHERED_PROP, &len);
+	if (plain) {
+		if (len != sizeof(*plain) || fdt32_to_cpu(*plain) > *size)
+			return -EINVAL;
+		plain_size = fdt32_to_cpu(*plain);
+	} else {
+		plain_size = *size;
+	}
+
+#if CONFIG_IS_ENABLED(DM_CRYPTO)
+	ret = fit_cipher_decrypt_hw(algo, key, iv, data, *size);
+#endif
+#if CONFIG_IS_ENABLED(AES)
+	if (ret == -ENODEV || ret == -ENOSYS || ret == -ENOTSUPP)
+		ret = fit_cipher_decrypt_sw(algo, key, iv, data, *size);
+#endif
+	if (ret) {
+		printf("Decrypting '%s' with %s failed: %d\n",
+		       fit_get_name(fit, noffset, NULL), algo_name, ret);
+		return ret;
+	}
+
+	*size = plain_size;
+
+	return 0;
+}
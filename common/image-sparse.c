@@ -49,6 +49,99 @@
 #define CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE (1024 * 512)
 #endif
 
+/*
+ * The FILL pattern buffer is kept across chunks and images and is only
+ * refilled when the pattern changes.
+ */
+static uint32_t *fill_buf;
+static unsigned int fill_buf_len;
+static uint32_t fill_buf_val;
+
+static uint32_t *get_fill_buf(unsigned int len, uint32_t fill_val)
+{
+	int i;
+
+	if (fill_buf && fill_buf_len != len) {
+		free(fill_buf);
+		fill_buf = NULL;
+	}
+
+	if (!fill_buf) {
+		fill_buf = memalign(ARCH_DMA_MINALIGN,
+				    ROUNDUP(len, ARCH_DMA_MINALIGN));
+		if (!fill_buf)
+			return NULL;
+		fill_buf_len = len;
+		fill_buf_val = ~fill_val;
+	}
+
+	if (fill_buf_val != fill_val) {
+		for (i = 0; i < len / sizeof(fill_val); i++)
+			fill_buf[i] = fill_val;
+		fill_buf_val = fill_val;
+	}
+
+	return fill_buf;
+}
+
+/*
+ * Write 'blkcnt' blocks of the current pattern at '*blk' and advance
+ * '*blk' past them. Return 0 on success, -1 on a write failure.
+ */
+static int write_fill_blocks(struct sparse_storage *info, lbaint_t *blk,
+			     lbaint_t blkcnt, lbaint_t fill_buf_num_blks)
+{
+	lbaint_t blks;
+	lbaint_t i, j;
+
+	for (i = 0; i < blkcnt;) {
+		j = blkcnt - i;
+		if (j > fill_buf_num_blks)
+			j = fill_buf_num_blks;
+		blks = info->write(info, *blk, j, fill_buf);
+		/* blks might be > j (eg. NAND bad-blocks) */
+		if (blks < j) {
+			printf("%s: %s " LBAFU " [" LBAFU "]\n",
+			       __func__, "Write failed, block #", *blk, j);
+			return -1;
+		}
+		*blk += blks;
+		i += j;
+	}
+
+	return 0;
+}
+
+/*
+ * A zero FILL chunk: erase the erase-group aligned middle of the range
+ * and write only the unaligned head and tail.
+ */
+static int erase_fill_blocks(struct sparse_storage *info, lbaint_t *blk,
+			     lbaint_t blkcnt, lbaint_t fill_buf_num_blks)
+{
+	lbaint_t grp = info->erase_grp;
+	lbaint_t head, mid;
+
+	head = (grp - (*blk & (grp - 1))) & (grp - 1);
+	if (head > blkcnt)
+		head = blkcnt;
+	mid = (blkcnt - head) & ~(grp - 1);
+
+	if (!mid)
+		return write_fill_blocks(info, blk, blkcnt, fill_buf_num_blks);
+
+	if (write_fill_blocks(info, blk, head, fill_buf_num_blks))
+		return -1;
+
+	if (info->erase(info, *blk, mid) == mid)
+		*blk += mid;
+	else if (write_fill_blocks(info, blk, mid, fill_buf_num_blks))
+		return -1;
+
+	return write_fill_blocks(info, blk, blkcnt - head - mid,
+				 fill_buf_num_blks);
+}
+
 void write_sparse_image(
 		struct sparse_storage *info, const char *part_name,
 		void *data, unsigned sz, char *response)
@@ -60,14 +153,12 @@ void write_sparse_image(
 	unsigned int chunk;
 	unsigned int offset;
 	unsigned int chunk_data_sz;
-	uint32_t *fill_buf = NULL;
 	uint32_t fill_val;
 	sparse_header_t *sparse_header;
 	chunk_header_t *chunk_header;
 	uint32_t total_blocks = 0;
 	int fill_buf_num_blks;
-	int i;
-	int j;
+	int ret;
 
 	fill_buf_num_blks = CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE / info->blksz;
 
@@ -174,26 +265,9 @@ void write_sparse_image(
 				return;
 			}
 
-			fill_buf = (uint32_t *)
-				   memalign(ARCH_DMA_MINALIGN,
-					    ROUNDUP(
-						info->blksz * fill_buf_num_blks,
-						ARCH_DMA_MINALIGN));
-			if (!fill_buf) {
-				fastboot_fail(
-					"Malloc failed for: CHUNK_TYPE_FILL", response);
-				return;
-			}
-
 			fill_val = *(uint32_t *)data;
 			data = (char *)data + sizeof(uint32_t);
 
-			for (i = 0;
-			     i < (info->blksz * fill_buf_num_blks /
-				  sizeof(fill_val));
-			     i++)
-				fill_buf[i] = fill_val;
-
 			if (blk + blkcnt > info->start + info->size) {
 				printf(
 				    "%s: Request would exceed partition size!\n",
@@ -203,28 +277,26 @@ void write_sparse_image(
 				return;
 			}
 
-			for (i = 0; i < blkcnt;) {
-				j = blkcnt - i;
-				if (j > fill_buf_num_blks)
-					j = fill_buf_num_blks;
-				blks = info->write(info, blk, j, fill_buf);
-				/* blks might be > j (eg. NAND bad-blocks) */
-				if (blks < j) {
-					printf("%s: %s " LBAFU " [%d]\n",
-					       __func__,
-					       "Write failed, block #",
-					       blk, j);
-					fastboot_fail(
-						      "flash write failure", response);
-					free(fill_buf);
-					return;
-				}
-				blk += blks;
-				i += j;
+			if (!get_fill_buf(info->blksz * fill_buf_num_blks,
+					  fill_val)) {
+				fastboot_fail(
+					"Malloc failed for: CHUNK_TYPE_FILL", response);
+				return;
+			}
+
+			if (!fill_val && info->erase && info->erase_grp)
+				ret = erase_fill_blocks(info, &blk, blkcnt,
+							fill_buf_num_blks);
+			else
+				ret = write_fill_blocks(info, &blk, blkcnt,
+							fill_buf_num_blks);
+			if (ret) {
+				fastboot_fail(
+					      "flash write failure", response);
+				return;
 			}
 			bytes_written += blkcnt * info->blksz;
 			total_blocks += chunk_data_sz / sparse_header->blk_sz;
-			free(fill_buf);
 			break;
 
 		case CHUNK_TYPE_DONT_CARE:
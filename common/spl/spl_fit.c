@@ -146,6 +146,111 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+static int spl_fit_image_get_os(const void *fit, int noffset, uint8_t *os)
+{
+#if CONFIG_IS_ENABLED(FIT_IMAGE_TINY)
+	return -ENOTSUPP;
+#else
+	return fit_image_get_os(fit, noffset, os);
+#endif
+}
+
+/*
+ * An image that was read along with the image loaded before it, see
+ * spl_fit_get_follower().
+ */
+static struct {
+	int node;
+	ulong addr;
+} spl_fit_preloaded = { .node = -1 };
+
+/* Whether the external data can be read straight to its final address */
+static bool spl_fit_can_read_direct(ulong addr)
+{
+#if  defined(CONFIG_ARCH_ROCKCHIP)
+	if ((addr < CONFIG_SYS_SDRAM_BASE) ||
+	     (addr >= CONFIG_SYS_SDRAM_BASE + SDRAM_MAX_SIZE))
+		return false;
+#endif
+	return !(addr & (ARCH_DMA_MINALIGN - 1));
+}
+
+/*
+ * Read the last, partial block of data read in place through a bounce
+ * block, so that the bytes after the data at its load address are kept.
+ * The bounce block is allocated once and kept for later images.
+ */
+static int spl_fit_read_tail(struct spl_load_info *info, ulong sector,
+			     void *dst, int len)
+{
+	static void *buf;
+	static int buf_len;
+
+	if (buf_len < info->bl_len) {
+		free(buf);
+		buf = memalign(ARCH_DMA_MINALIGN, info->bl_len);
+		buf_len = buf ? info->bl_len : 0;
+		if (!buf)
+			return -ENOMEM;
+	}
+
+	if (info->read(info, sector, 1, buf) != 1)
+		return -EIO;
+
+	memcpy(dst, buf, len);
+
+	return 0;
+}
+
+/*
+ * Find the image whose external data directly follows @end in the FIT and
+ * whose load address is @dest, so that it can be read with the same
+ * info->read() as the image ending at @end. An FDT without a load address
+ * following U-Boot qualifies too, as spl_fit_append_fdt() places it right
+ * after U-Boot. The image found is recorded in spl_fit_preloaded.
+ *
+ * Return:	the data size of the image, or 0 if there is none
+ */
+static int spl_fit_get_follower(const void *fit, int node, ulong base_offset,
+				int end, ulong dest)
+{
+	int images = fdt_parent_offset(fit, node);
+	uint8_t comp, type, os;
+	int noffset, offset, len;
+	ulong load;
+
+	fdt_for_each_subnode(noffset, fit, images) {
+		if (fit_image_get_data_position(fit, noffset, &offset)) {
+			if (fit_image_get_data_offset(fit, noffset, &offset))
+				continue;
+			offset += base_offset;
+		}
+		if (offset != end)
+			continue;
+
+		if (!fit_image_get_comp(fit, noffset, &comp) &&
+		    comp == IH_COMP_GZIP)
+			return 0;
+		if (fit_image_get_load(fit, noffset, &load)) {
+			if (fit_image_get_type(fit, noffset, &type) ||
+			    type != IH_TYPE_FLATDT ||
+			    spl_fit_image_get_os(fit, node, &os) ||
+			    os != IH_OS_U_BOOT)
+				return 0;
+			load = dest;
+		}
+		if (load != dest || fit_image_get_data_size(fit, noffset, &len))
+			return 0;
+
+		spl_fit_preloaded.node = noffset;
+		spl_fit_preloaded.addr = dest;
+
+		return len;
+	}
+
+	return 0;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -179,6 +284,9 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	uint8_t image_comp = -1, type = -1;
 	const void *data;
 	bool external_data = false;
+	bool decomp;
+	int extra = 0;
+	int tail = 0;
 
 	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) {
 		if (fit_image_get_comp(fit, node, &image_comp))
@@ -197,6 +305,11 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	if (fit_image_get_load(fit, node, &load_addr))
 		load_addr = image_info->load_addr;
 
+	decomp = IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
+		 IS_ENABLED(CONFIG_SPL_GZIP)	&&
+		 image_comp == IH_COMP_GZIP	&&
+		 type == IH_TYPE_KERNEL;
+
 	if (image_comp != IH_COMP_NONE && image_comp != IH_COMP_ZIMAGE) {
 		/* Empirically, 2MB is enough for U-Boot, tee and atf */
 		if (fit_image_get_comp_addr(fit, node, &comp_addr))
@@ -217,27 +330,67 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
 
-		load_ptr = (comp_addr + align_len) & ~align_len;
+		length = len;
+		overhead = get_aligned_image_overhead(info, offset);
+
+		if (spl_fit_preloaded.node == node &&
+		    spl_fit_preloaded.addr == load_addr) {
+			spl_fit_preloaded.node = -1;
+			debug("External data: preloaded at %lx, size=%lx\n",
+			      load_addr, (unsigned long)length);
+			src = (void *)load_addr;
+			goto verify;
+		}
+		spl_fit_preloaded.node = -1;
+
+		/*
+		 * Data starting on a block boundary that is not decompressed
+		 * is read straight to its load address, along with the image
+		 * following it if that one is to be loaded right after it.
+		 */
+		if (!decomp && !overhead && spl_fit_can_read_direct(load_addr)) {
+			load_ptr = load_addr;
+			extra = spl_fit_get_follower(fit, node, base_offset,
+						     offset + len,
+						     load_addr + len);
+		} else {
+			load_ptr = (comp_addr + align_len) & ~align_len;
 #if  defined(CONFIG_ARCH_ROCKCHIP)
-		if ((load_ptr < CONFIG_SYS_SDRAM_BASE) ||
-		     (load_ptr >= CONFIG_SYS_SDRAM_BASE + SDRAM_MAX_SIZE))
-			load_ptr = (ulong)memalign(ARCH_DMA_MINALIGN, len);
+			if ((load_ptr < CONFIG_SYS_SDRAM_BASE) ||
+			     (load_ptr >= CONFIG_SYS_SDRAM_BASE + SDRAM_MAX_SIZE))
+				load_ptr = (ulong)memalign(ARCH_DMA_MINALIGN,
+							   len);
 #endif
-		length = len;
+		}
 
-		overhead = get_aligned_image_overhead(info, offset);
-		nr_sectors = get_aligned_image_size(info, length, offset);
+		nr_sectors = get_aligned_image_size(info, length + extra,
+						    offset);
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, (void *)load_ptr) != nr_sectors)
+		/* At the load address, a whole last block would overrun it */
+		if (load_ptr == load_addr && !info->filename) {
+			tail = (overhead + length + extra) % info->bl_len;
+			if (tail)
+				nr_sectors--;
+		}
+
+		sector += get_aligned_image_offset(info, offset);
+		if ((nr_sectors &&
+		     info->read(info, sector, nr_sectors,
+				(void *)load_ptr) != nr_sectors) ||
+		    (tail &&
+		     spl_fit_read_tail(info, sector + nr_sectors,
+				       (void *)load_ptr +
+				       nr_sectors * info->bl_len, tail))) {
+			spl_fit_preloaded.node = -1;
 			return -EIO;
+		}
 
-		debug("External data: dst=%lx, offset=%x, size=%lx\n",
-		      load_ptr, offset, (unsigned long)length);
+		debug("External data: dst=%lx, offset=%x, size=%lx+%x\n",
+		      load_ptr, offset, (unsigned long)length, extra);
 		src = (void *)load_ptr + overhead;
 	} else {
 		/* Embedded data */
+		spl_fit_preloaded.node = -1;
 		if (fit_image_get_data(fit, node, &data, &length)) {
 			puts("Cannot get image data/size\n");
 			return -ENOENT;
@@ -247,6 +400,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		src = (void *)data;
 	}
 
+verify:
 	/* Check hashes and signature */
 	if (image_comp != IH_COMP_NONE && image_comp != IH_COMP_ZIMAGE)
 		printf("## Checking %s 0x%08lx (%s @0x%08lx) ... ",
@@ -265,16 +419,18 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 					 src, length))
 		return -EPERM;
 
+#if CONFIG_IS_ENABLED(FIT_CIPHER)
+	if (fit_image_uncipher(fit, node, src, &length))
+		return -EACCES;
+#endif
+
 #ifdef CONFIG_SPL_FIT_IMAGE_POST_PROCESS
 	board_fit_image_post_process(fit, node, (ulong *)&load_addr,
 				     (ulong **)&src, &length, info);
 #endif
 	puts("OK\n");
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
-	    IS_ENABLED(CONFIG_SPL_GZIP)		&&
-	    image_comp == IH_COMP_GZIP		&&
-	    type == IH_TYPE_KERNEL) {
+	if (decomp) {
 		size = length;
 		if (gunzip((void *)load_addr, CONFIG_SYS_BOOTM_LEN,
 			   src, &size)) {
@@ -282,8 +438,8 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
-	} else {
-		memcpy((void *)load_addr, src, length);
+	} else if (src != (void *)load_addr) {
+		memmove((void *)load_addr, src, length);
 	}
 
 	if (image_info) {
@@ -370,15 +526,6 @@ static int spl_fit_record_loadable(const void *fit, int images, int index,
 	return ret;
 }
 
-static int spl_fit_image_get_os(const void *fit, int noffset, uint8_t *os)
-{
-#if CONFIG_IS_ENABLED(FIT_IMAGE_TINY)
-	return -ENOTSUPP;
-#else
-	return fit_image_get_os(fit, noffset, os);
-#endif
-}
-
 __weak int spl_fit_standalone_release(char *id, uintptr_t entry_point)
 {
 	return 0;
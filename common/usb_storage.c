@@ -99,6 +99,7 @@ struct us_data {
 	trans_reset	transport_reset;	/* reset routine */
 	trans_cmnd	transport;		/* transport routine */
 	unsigned short	max_xfer_blk;		/* maximum transfer blocks */
+	size_t		max_xfer_size;		/* host limit in bytes, 0: none */
 };
 
 #ifndef CONFIG_BLK
@@ -958,21 +959,48 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	 * Windows 7 limiting transfers to 128 sectors for both USB2 and USB3
 	 * and Apple Mac OS X 10.11 limiting transfers to 256 sectors for USB2
 	 * and 2048 for USB3 devices.
+	 *
+	 * Follow the latter for SuperSpeed devices: at 240 sectors the fixed
+	 * CBW/CSW round trip per command costs a large share of the link rate
+	 * of a USB3 SSD. The host controller limit below still applies.
 	 */
 	unsigned short blk = 240;
 
+	if (udev->speed >= USB_SPEED_SUPER)
+		blk = 2048;
+
 #if CONFIG_IS_ENABLED(DM_USB)
 	size_t size;
 	int ret;
 
+	us->max_xfer_size = 0;
 	ret = usb_get_max_xfer_size(udev, (size_t *)&size);
-	if ((ret >= 0) && (size < blk * 512))
-		blk = size / 512;
+	if (ret >= 0) {
+		us->max_xfer_size = size;
+		if (size < blk * 512)
+			blk = size / 512;
+	}
 #endif
 
 	us->max_xfer_blk = blk;
 }
 
+/*
+ * max_xfer_blk is set up before READ CAPACITY and counts 512 byte sectors,
+ * so also keep a single command within the host limit for larger blocks.
+ */
+static unsigned short usb_stor_max_xfer_blk(struct us_data *ss,
+					    struct blk_desc *block_dev)
+{
+	unsigned short blk = ss->max_xfer_blk;
+
+	if (ss->max_xfer_size &&
+	    (size_t)blk * block_dev->blksz > ss->max_xfer_size)
+		blk = max_t(size_t, ss->max_xfer_size / block_dev->blksz, 1);
+
+	return blk;
+}
+
 static int usb_inquiry(struct scsi_cmd *srb, struct us_data *ss)
 {
 	int retry, i;
@@ -1134,7 +1162,7 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned short smallblks, max_blks;
 	struct usb_device *udev;
 	struct us_data *ss;
 	int retry;
@@ -1159,6 +1187,7 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 	}
 #endif
 	ss = (struct us_data *)udev->privptr;
+	max_blks = usb_stor_max_xfer_blk(ss, block_dev);
 
 	usb_disable_asynch(1); /* asynch transfer not allowed */
 	srb->lun = block_dev->lun;
@@ -1173,12 +1202,12 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 		/* XXX need some comment here */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > ss->max_xfer_blk)
-			smallblks = ss->max_xfer_blk;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
 			smallblks = (unsigned short) blks;
 retry_it:
-		if (smallblks == ss->max_xfer_blk)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
@@ -1201,7 +1230,7 @@ retry_it:
 	      start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= ss->max_xfer_blk)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 }
@@ -1216,7 +1245,7 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned short smallblks, max_blks;
 	struct usb_device *udev;
 	struct us_data *ss;
 	int retry;
@@ -1242,6 +1271,7 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 	}
 #endif
 	ss = (struct us_data *)udev->privptr;
+	max_blks = usb_stor_max_xfer_blk(ss, block_dev);
 
 	usb_disable_asynch(1); /* asynch transfer not allowed */
 
@@ -1259,12 +1289,12 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 		 */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > ss->max_xfer_blk)
-			smallblks = ss->max_xfer_blk;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
 			smallblks = (unsigned short) blks;
 retry_it:
-		if (smallblks == ss->max_xfer_blk)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
@@ -1286,7 +1316,7 @@ retry_it:
 	      PRIxPTR "\n", start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= ss->max_xfer_blk)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 
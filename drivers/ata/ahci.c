@@ -46,6 +46,14 @@ struct ahci_uc_priv *probe_ent = NULL;
  */
 #ifndef MAX_SATA_BLOCKS_READ_WRITE
 #define MAX_SATA_BLOCKS_READ_WRITE	0x80
+/*
+ * Queued reads keep several commands in flight, so each of them can be
+ * larger without the drive sitting idle between commands. Boards that
+ * override the limit above get it for queued reads as well.
+ */
+#define MAX_SATA_BLOCKS_NCQ		0x800
+#else
+#define MAX_SATA_BLOCKS_NCQ		MAX_SATA_BLOCKS_READ_WRITE
 #endif
 
 /* Maximum timeouts for each event */
@@ -494,11 +502,12 @@ static int ahci_init_one(struct ahci_uc_priv *uc_priv, pci_dev_t dev)
 
 #define MAX_DATA_BYTE_COUNT  (4*1024*1024)
 
-static int ahci_fill_sg(struct ahci_uc_priv *uc_priv, u8 port,
+static int ahci_fill_sg(struct ahci_uc_priv *uc_priv, u8 port, int tag,
 			unsigned char *buf, int buf_len)
 {
 	struct ahci_ioports *pp = &(uc_priv->port[port]);
-	struct ahci_sg *ahci_sg = pp->cmd_tbl_sg;
+	struct ahci_sg *ahci_sg = (void *)pp->cmd_tbl_sg +
+				  tag * AHCI_CMD_TBL_SZ;
 	u32 sg_count;
 	int i;
 
@@ -530,14 +539,17 @@ static int ahci_fill_sg(struct ahci_uc_priv *uc_priv, u8 port,
 }
 
 
-static void ahci_fill_cmd_slot(struct ahci_ioports *pp, u32 opts)
+static void ahci_fill_cmd_slot(struct ahci_ioports *pp, int tag, u32 opts)
 {
-	pp->cmd_slot->opts = cpu_to_le32(opts);
-	pp->cmd_slot->status = 0;
-	pp->cmd_slot->tbl_addr = cpu_to_le32((u32)pp->cmd_tbl & 0xffffffff);
+	struct ahci_cmd_hdr *cmd_slot = pp->cmd_slot + tag;
+	ulong cmd_tbl = pp->cmd_tbl + tag * AHCI_CMD_TBL_SZ;
+
+	cmd_slot->opts = cpu_to_le32(opts);
+	cmd_slot->status = 0;
+	cmd_slot->tbl_addr = cpu_to_le32((u32)cmd_tbl & 0xffffffff);
 #ifdef CONFIG_PHYS_64BIT
-	pp->cmd_slot->tbl_addr_hi =
-	    cpu_to_le32((u32)(((pp->cmd_tbl) >> 16) >> 16));
+	cmd_slot->tbl_addr_hi =
+	    cpu_to_le32((u32)(((cmd_tbl) >> 16) >> 16));
 #endif
 }
 
@@ -563,6 +575,7 @@ static int ahci_port_start(struct ahci_uc_priv *uc_priv, u8 port)
 	u64 dma_addr;
 	u32 port_status;
 	void __iomem *mem;
+	int dma_size;
 
 	debug("Enter start port: %d\n", port);
 	port_status = readl(port_mmio + PORT_SCR_STAT);
@@ -572,13 +585,22 @@ static int ahci_port_start(struct ahci_uc_priv *uc_priv, u8 port)
 		return -1;
 	}
 
-	mem = memalign(2048, AHCI_PORT_PRIV_DMA_SZ);
+	/* Queued commands each need their own command table */
+	if (uc_priv->cap & HOST_CAP_NCQ)
+		pp->n_slots = min_t(u32, HOST_CAP_NCS(uc_priv->cap),
+				    AHCI_NCQ_SLOTS);
+	else
+		pp->n_slots = 1;
+	pp->ncq_depth = 0;
+	dma_size = AHCI_PORT_PRIV_DMA_SZ + (pp->n_slots - 1) * AHCI_CMD_TBL_SZ;
+
+	mem = memalign(2048, dma_size);
 	if (!mem) {
 		free(pp);
 		printf("%s: No mem for table!\n", __func__);
 		return -ENOMEM;
 	}
-	memset(mem, 0, AHCI_PORT_PRIV_DMA_SZ);
+	memset(mem, 0, dma_size);
 
 	/*
 	 * First item in chunk of DMA memory: 32-slot command table,
@@ -587,7 +609,7 @@ static int ahci_port_start(struct ahci_uc_priv *uc_priv, u8 port)
 	pp->cmd_slot =
 		(struct ahci_cmd_hdr *)(uintptr_t)virt_to_phys((void *)mem);
 	debug("cmd_slot = %p\n", pp->cmd_slot);
-	mem += (AHCI_CMD_SLOT_SZ + 224);
+	mem += AHCI_CMD_SLOT_SZ * AHCI_MAX_CMD_SLOT;
 
 	/*
 	 * Second item: Received-FIS area
@@ -596,8 +618,8 @@ static int ahci_port_start(struct ahci_uc_priv *uc_priv, u8 port)
 	mem += AHCI_RX_FIS_SZ;
 
 	/*
-	 * Third item: data area for storing a single command
-	 * and its scatter-gather table
+	 * Third item: data area for storing one command and its
+	 * scatter-gather table per command slot
 	 */
 	pp->cmd_tbl = virt_to_phys((void *)mem);
 	debug("cmd_tbl_dma = %lx\n", pp->cmd_tbl);
@@ -656,9 +678,9 @@ static int ahci_device_data_io(struct ahci_uc_priv *uc_priv, u8 port, u8 *fis,
 
 	memcpy((unsigned char *)pp->cmd_tbl, fis, fis_len);
 
-	sg_count = ahci_fill_sg(uc_priv, port, buf, buf_len);
+	sg_count = ahci_fill_sg(uc_priv, port, 0, buf, buf_len);
 	opts = (fis_len >> 2) | (sg_count << 16) | (is_write << 6);
-	ahci_fill_cmd_slot(pp, opts);
+	ahci_fill_cmd_slot(pp, 0, opts);
 
 	ahci_dcache_flush_sata_cmd(pp);
 	ahci_dcache_flush_range((unsigned long)buf, (unsigned long)buf_len);
@@ -741,6 +763,11 @@ static int ata_scsiop_inquiry(struct ahci_uc_priv *uc_priv,
 	memcpy(idbuf, tmpid, ATA_ID_WORDS * 2);
 	ata_swap_buf_le16(idbuf, ATA_ID_WORDS);
 
+	if (uc_priv->port[port].n_slots > 1 && ata_id_has_ncq(idbuf))
+		uc_priv->port[port].ncq_depth =
+			min_t(u32, uc_priv->port[port].n_slots,
+			      ata_id_queue_depth(idbuf));
+
 	memcpy(&pccb->pdata[8], "ATA     ", 8);
 	ata_id_strcpy((u16 *)&pccb->pdata[16], &idbuf[ATA_ID_PROD], 16);
 	ata_id_strcpy((u16 *)&pccb->pdata[32], &idbuf[ATA_ID_FW_REV], 4);
@@ -752,6 +779,131 @@ static int ata_scsiop_inquiry(struct ahci_uc_priv *uc_priv,
 }
 
 
+/*
+ * Recover from a failed queued command. The drive aborts all outstanding
+ * queued commands and only accepts new ones once the NCQ error log has
+ * been read, so do that after restarting the port's command list engine.
+ * Queuing stays disabled on the port afterwards.
+ */
+static void ahci_ncq_recover(struct ahci_uc_priv *uc_priv, u8 port)
+{
+	struct ahci_ioports *pp = &(uc_priv->port[port]);
+	void __iomem *port_mmio = pp->port_mmio;
+	ALLOC_CACHE_ALIGN_BUFFER(u8, log, ATA_SECT_SIZE);
+	u8 fis[20];
+	u32 tmp;
+
+	tmp = readl(port_mmio + PORT_CMD);
+	writel_with_flush(tmp & ~PORT_CMD_START, port_mmio + PORT_CMD);
+	waiting_for_cmd_completed(port_mmio + PORT_CMD, 500,
+				  PORT_CMD_LIST_ON);
+	writel(readl(port_mmio + PORT_SCR_ERR), port_mmio + PORT_SCR_ERR);
+	writel(readl(port_mmio + PORT_IRQ_STAT), port_mmio + PORT_IRQ_STAT);
+	writel_with_flush(tmp | PORT_CMD_START, port_mmio + PORT_CMD);
+
+	memset(fis, 0, sizeof(fis));
+	fis[0] = 0x27;		/* Host to device FIS. */
+	fis[1] = 1 << 7;	/* Command FIS. */
+	fis[2] = ATA_CMD_READ_LOG_EXT;
+	fis[4] = ATA_LOG_SATA_NCQ;
+	fis[12] = 1;		/* one sector */
+	if (ahci_device_data_io(uc_priv, port, fis, sizeof(fis), log,
+				ATA_SECT_SIZE, 0))
+		debug("scsi_ahci: reading NCQ error log failed\n");
+
+	pp->ncq_depth = 0;
+}
+
+/*
+ * Read with READ FPDMA QUEUED, keeping up to ncq_depth commands in flight
+ * on the port and refilling slots as the drive completes them.
+ */
+static int ahci_ncq_read(struct ahci_uc_priv *uc_priv, u8 port,
+			 lbaint_t lba, u32 blocks, u8 *buf)
+{
+	struct ahci_ioports *pp = &(uc_priv->port[port]);
+	void __iomem *port_mmio = pp->port_mmio;
+	u32 len = blocks * ATA_SECT_SIZE;
+	u32 busy = 0, done;
+	ulong start;
+	int tag, sg_count;
+	u8 *fis;
+
+	ahci_dcache_flush_range((unsigned long)buf, len);
+	writel(readl(port_mmio + PORT_IRQ_STAT), port_mmio + PORT_IRQ_STAT);
+
+	start = get_timer(0);
+	while (blocks || busy) {
+		for (tag = 0; blocks && tag < pp->ncq_depth; tag++) {
+			u32 now_blocks = min_t(u32, MAX_SATA_BLOCKS_NCQ,
+					       blocks);
+
+			if (busy & BIT(tag))
+				continue;
+
+			fis = (u8 *)pp->cmd_tbl + tag * AHCI_CMD_TBL_SZ;
+			memset(fis, 0, 20);
+			fis[0] = 0x27;		/* Host to device FIS. */
+			fis[1] = 1 << 7;	/* Command FIS. */
+			fis[2] = ATA_CMD_FPDMA_READ;
+			fis[3] = now_blocks & 0xff;	/* count in features */
+			fis[11] = (now_blocks >> 8) & 0xff;
+			fis[4] = (lba >> 0) & 0xff;
+			fis[5] = (lba >> 8) & 0xff;
+			fis[6] = (lba >> 16) & 0xff;
+			fis[7] = 1 << 6;	/* device reg: set LBA mode */
+			fis[8] = (lba >> 24) & 0xff;
+#ifdef CONFIG_SYS_64BIT_LBA
+			fis[9] = (lba >> 32) & 0xff;
+			fis[10] = (lba >> 40) & 0xff;
+#endif
+			fis[12] = tag << 3;
+
+			sg_count = ahci_fill_sg(uc_priv, port, tag, buf,
+						now_blocks * ATA_SECT_SIZE);
+			if (sg_count < 0)
+				return -EIO;
+			ahci_fill_cmd_slot(pp, tag, 5 | (sg_count << 16));
+			ahci_dcache_flush_range((unsigned long)fis,
+						AHCI_CMD_TBL_SZ);
+			ahci_dcache_flush_range((unsigned long)pp->cmd_slot,
+						AHCI_CMD_SLOT_SZ *
+						AHCI_MAX_CMD_SLOT);
+
+			writel(BIT(tag), port_mmio + PORT_SCR_ACT);
+			writel_with_flush(BIT(tag), port_mmio + PORT_CMD_ISSUE);
+			busy |= BIT(tag);
+
+			buf += now_blocks * ATA_SECT_SIZE;
+			lba += now_blocks;
+			blocks -= now_blocks;
+		}
+
+		if (readl(port_mmio + PORT_IRQ_STAT) & (PORT_IRQ_FATAL)) {
+			printf("scsi_ahci: queued read failed on port %d\n",
+			       port);
+			ahci_ncq_recover(uc_priv, port);
+			return -EIO;
+		}
+
+		done = busy & ~(readl(port_mmio + PORT_SCR_ACT) |
+				readl(port_mmio + PORT_CMD_ISSUE));
+		if (done) {
+			busy &= ~done;
+			start = get_timer(0);
+		} else if (get_timer(start) > WAIT_MS_DATAIO) {
+			printf("scsi_ahci: queued read timeout on port %d\n",
+			       port);
+			ahci_ncq_recover(uc_priv, port);
+			return -EIO;
+		}
+	}
+
+	ahci_dcache_invalidate_range((unsigned long)buf - len, len);
+
+	return 0;
+}
+
 /*
  * SCSI READ10/WRITE10 command operation.
  */
@@ -793,6 +945,17 @@ static int ata_scsiop_read_write(struct ahci_uc_priv *uc_priv,
 	debug("scsi_ahci: %s %u blocks starting from lba 0x" LBAFU "\n",
 	      is_write ?  "write" : "read", blocks, lba);
 
+	if (!is_write && uc_priv->port[pccb->target].ncq_depth > 1) {
+		if (blocks * ATA_SECT_SIZE > user_buffer_size) {
+			printf("scsi_ahci: Error: buffer too small.\n");
+			return -EIO;
+		}
+		if (!ahci_ncq_read(uc_priv, pccb->target, lba, blocks,
+				   user_buffer))
+			return 0;
+		/* Queuing is now off on the port, retry without it */
+	}
+
 	/* Preset the FIS */
 	memset(fis, 0, sizeof(fis));
 	fis[0] = 0x27;		 /* Host to device FIS. */
@@ -1125,7 +1288,7 @@ static int ata_io_flush(struct ahci_uc_priv *uc_priv, u8 port)
 	fis[2] = ATA_CMD_FLUSH_EXT;
 
 	memcpy((unsigned char *)pp->cmd_tbl, fis, 20);
-	ahci_fill_cmd_slot(pp, cmd_fis_len);
+	ahci_fill_cmd_slot(pp, 0, cmd_fis_len);
 	ahci_dcache_flush_sata_cmd(pp);
 	writel_with_flush(1, port_mmio + PORT_CMD_ISSUE);
 
@@ -129,6 +129,35 @@ int crypto_sha_update(struct udevice *dev, u32 *input, u32 len)
 	return ops->sha_update(dev, input, len);
 }
 
+int crypto_sha_update_async(struct udevice *dev, u32 *input, u32 len)
+{
+	const struct dm_crypto_ops *ops = device_get_ops(dev);
+
+	if (!len)
+		return 0;
+
+	if (!ops)
+		return -ENOSYS;
+
+	if (!ops->sha_update_async)
+		return crypto_sha_update(dev, input, len);
+
+	return ops->sha_update_async(dev, input, len);
+}
+
+int crypto_wait(struct udevice *dev)
+{
+	const struct dm_crypto_ops *ops = device_get_ops(dev);
+
+	if (!ops)
+		return -ENOSYS;
+
+	if (!ops->wait)
+		return 0;
+
+	return ops->wait(dev);
+}
+
 int crypto_sha_final(struct udevice *dev, sha_context *ctx, u8 *output)
 {
 	const struct dm_crypto_ops *ops = device_get_ops(dev);
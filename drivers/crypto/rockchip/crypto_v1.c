@@ -33,6 +33,9 @@ struct rockchip_crypto_priv {
 	char				*clocks;
 	u32				nclocks;
 	u32				length;
+	u32				pending_len;
+	u8				dma_pending;
+	u8				async;
 };
 
 static u32 rockchip_crypto_capability(struct udevice *dev)
@@ -45,6 +48,22 @@ static u32 rockchip_crypto_capability(struct udevice *dev)
 	       CRYPTO_RSA2048;
 }
 
+static int rk_hash_dma_wait(struct rockchip_crypto_priv *priv)
+{
+	struct rk_crypto_reg *reg = priv->reg;
+
+	if (!priv->dma_pending)
+		return 0;
+
+	/* Wait last complete */
+	do {} while (readl(&reg->crypto_ctrl) & HASH_START);
+
+	priv->dma_pending = 0;
+	priv->length += priv->pending_len;
+
+	return 0;
+}
+
 static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 			       u32 data_len, u8 *started_flag, u8 is_last)
 {
@@ -54,6 +73,8 @@ static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 	if (!data_len)
 		return -EINVAL;
 
+	rk_hash_dma_wait(priv);
+
 	/* Must flush dcache before crypto DMA fetch data region */
 	crypto_flush_cacheline((ulong)data, data_len);
 
@@ -67,12 +88,14 @@ static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 	/* Write 1 to start. When finishes, the core will clear it */
 	rk_setreg(&reg->crypto_ctrl, HASH_START);
 
-	/* Wait last complete */
-	do {} while (readl(&reg->crypto_ctrl) & HASH_START);
+	priv->pending_len = data_len;
+	priv->dma_pending = 1;
 
-	priv->length += data_len;
+	/* The cache buffer is refilled as soon as this returns */
+	if (priv->async && data != priv->hash_cache->cache)
+		return 0;
 
-	return 0;
+	return rk_hash_dma_wait(priv);
 }
 
 static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
@@ -89,6 +112,9 @@ static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
 		return -EINVAL;
 	}
 
+	/* A digest abandoned mid-way may still have its last chunk in flight */
+	rk_hash_dma_wait(priv);
+
 	priv->hash_cache = crypto_hash_cache_alloc(rk_hash_direct_calc,
 						   priv, ctx->length,
 						   DATA_ADDR_ALIGN_SIZE,
@@ -98,6 +124,8 @@ static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
 
 	priv->ctx = ctx;
 	priv->length = 0;
+	priv->dma_pending = 0;
+	priv->async = 0;
 	writel(ctx->length, &reg->crypto_hash_msg_len);
 	if (ctx->algo == CRYPTO_SHA256) {
 		/* Set SHA256 mode and out byte swap */
@@ -141,8 +169,7 @@ static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
 	return 0;
 }
 
-static int rockchip_crypto_sha_update(struct udevice *dev,
-				      u32 *input, u32 len)
+static int rk_crypto_sha_feed(struct udevice *dev, u32 *input, u32 len)
 {
 	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
 	int ret = -EINVAL, i;
@@ -166,6 +193,7 @@ static int rockchip_crypto_sha_update(struct udevice *dev,
 
 exit:
 	if (ret) {
+		rk_hash_dma_wait(priv);
 		crypto_hash_cache_free(priv->hash_cache);
 		priv->hash_cache = NULL;
 	}
@@ -173,6 +201,39 @@ exit:
 	return ret;
 }
 
+static int rockchip_crypto_sha_update(struct udevice *dev,
+				      u32 *input, u32 len)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+	int ret;
+
+	ret = rk_crypto_sha_feed(dev, input, len);
+	if (ret)
+		return ret;
+
+	return rk_hash_dma_wait(priv);
+}
+
+static int rockchip_crypto_sha_update_async(struct udevice *dev,
+					    u32 *input, u32 len)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+	int ret;
+
+	priv->async = 1;
+	ret = rk_crypto_sha_feed(dev, input, len);
+	priv->async = 0;
+
+	return ret;
+}
+
+static int rockchip_crypto_wait(struct udevice *dev)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+
+	return rk_hash_dma_wait(priv);
+}
+
 static int rockchip_crypto_sha_final(struct udevice *dev,
 				     sha_context *ctx, u8 *output)
 {
@@ -183,6 +244,8 @@ static int rockchip_crypto_sha_final(struct udevice *dev,
 	u32 nbits;
 	int i;
 
+	rk_hash_dma_wait(priv);
+
 	if (priv->length != ctx->length) {
 		printf("total length(0x%08x) != init length(0x%08x)!\n",
 		       priv->length, ctx->length);
@@ -277,6 +340,8 @@ static const struct dm_crypto_ops rockchip_crypto_ops = {
 	.sha_init   = rockchip_crypto_sha_init,
 	.sha_update = rockchip_crypto_sha_update,
 	.sha_final  = rockchip_crypto_sha_final,
+	.sha_update_async = rockchip_crypto_sha_update_async,
+	.wait       = rockchip_crypto_wait,
 	.rsa_verify = rockchip_crypto_rsa_verify,
 };
 
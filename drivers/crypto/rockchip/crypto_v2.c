@@ -39,8 +39,11 @@ struct rk_hash_ctx {
 	struct crypto_hash_cache	*hash_cache;
 	u32				magic;		/* to check ctx */
 	u32				algo;		/* hash algo */
+	u32				pending_len;	/* len of dma in flight */
 	u8				digest_size;	/* hash out length */
-	u8				reserved[3];
+	u8				dma_pending;	/* dma not waited yet */
+	u8				async;		/* leave dma in flight */
+	u8				reserved[1];
 };
 
 struct rk_crypto_soc_data {
@@ -367,6 +370,41 @@ exit:
 	return ret;
 }
 
+static int rk_hash_dma_wait(struct rockchip_crypto_priv *priv)
+{
+	struct rk_hash_ctx *hash_ctx = priv->hw_ctx;
+	int ret = 0;
+	u32 tmp = 0, mask = 0;
+
+	if (!hash_ctx->dma_pending)
+		return 0;
+
+	hash_ctx->dma_pending = 0;
+
+	/* mask CRYPTO_SYNC_LOCKSTEP_INT_ST flag */
+	mask = ~(mask | CRYPTO_SYNC_LOCKSTEP_INT_ST);
+
+	/* wait calc ok */
+	ret = RK_POLL_TIMEOUT(!(crypto_read(CRYPTO_DMA_INT_ST) & mask),
+			      RK_CRYPTO_TIMEOUT);
+
+	/* clear interrupt status */
+	tmp = crypto_read(CRYPTO_DMA_INT_ST);
+	crypto_write(tmp, CRYPTO_DMA_INT_ST);
+
+	if ((tmp & mask) != CRYPTO_SRC_ITEM_DONE_INT_ST &&
+	    (tmp & mask) != CRYPTO_ZERO_LEN_INT_ST) {
+		ret = -EFAULT;
+		debug("[%s] %d: CRYPTO_DMA_INT_ST = 0x%x\n",
+		      __func__, __LINE__, tmp);
+		goto exit;
+	}
+
+	priv->length += hash_ctx->pending_len;
+exit:
+	return ret;
+}
+
 static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 			       u32 data_len, u8 *started_flag, u8 is_last)
 {
@@ -374,7 +412,12 @@ static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 	struct rk_hash_ctx *hash_ctx = priv->hw_ctx;
 	struct crypto_lli_desc *lli = &hash_ctx->data_lli;
 	int ret = -EINVAL;
-	u32 tmp = 0, mask = 0;
+	u32 tmp = 0;
+
+	/* the lli is shared, the previous item must be done first */
+	ret = rk_hash_dma_wait(priv);
+	if (ret)
+		return ret;
 
 	assert(IS_ALIGNED((ulong)data, DATA_ADDR_ALIGN_SIZE));
 	assert(is_last || IS_ALIGNED(data_len, DATA_LEN_ALIGN_SIZE));
@@ -415,28 +458,17 @@ static int rk_hash_direct_calc(void *hw_data, const u8 *data,
 	crypto_write(tmp << CRYPTO_WRITE_MASK_SHIFT | tmp,
 		     CRYPTO_DMA_CTL);
 
-	/* mask CRYPTO_SYNC_LOCKSTEP_INT_ST flag */
-	mask = ~(mask | CRYPTO_SYNC_LOCKSTEP_INT_ST);
-
-	/* wait calc ok */
-	ret = RK_POLL_TIMEOUT(!(crypto_read(CRYPTO_DMA_INT_ST) & mask),
-			      RK_CRYPTO_TIMEOUT);
-
-	/* clear interrupt status */
-	tmp = crypto_read(CRYPTO_DMA_INT_ST);
-	crypto_write(tmp, CRYPTO_DMA_INT_ST);
+	hash_ctx->pending_len = data_len;
+	hash_ctx->dma_pending = 1;
 
-	if ((tmp & mask) != CRYPTO_SRC_ITEM_DONE_INT_ST &&
-	    (tmp & mask) != CRYPTO_ZERO_LEN_INT_ST) {
-		ret = -EFAULT;
-		debug("[%s] %d: CRYPTO_DMA_INT_ST = 0x%x\n",
-		      __func__, __LINE__, tmp);
-		goto exit;
-	}
+	/*
+	 * Only the caller's buffer may stay in flight, the cache buffer is
+	 * refilled by crypto_hash_update_with_cache() right after this.
+	 */
+	if (hash_ctx->async && data != hash_ctx->hash_cache->cache)
+		return 0;
 
-	priv->length += data_len;
-exit:
-	return ret;
+	return rk_hash_dma_wait(priv);
 }
 
 int rk_hash_update(void *ctx, const u8 *data, u32 data_len)
@@ -524,6 +556,9 @@ static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
 	if (!ctx)
 		return -EINVAL;
 
+	/* A digest abandoned mid-way may still have its last chunk in flight */
+	rk_hash_dma_wait(priv);
+
 	memset(hash_ctx, 0x00, sizeof(*hash_ctx));
 
 	priv->length = 0;
@@ -538,8 +573,7 @@ static int rockchip_crypto_sha_init(struct udevice *dev, sha_context *ctx)
 	return rk_hash_init(hash_ctx, ctx->algo);
 }
 
-static int rockchip_crypto_sha_update(struct udevice *dev,
-				      u32 *input, u32 len)
+static int rk_crypto_sha_feed(struct udevice *dev, u32 *input, u32 len)
 {
 	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
 	int ret, i;
@@ -563,6 +597,39 @@ exit:
 	return ret;
 }
 
+static int rockchip_crypto_sha_update(struct udevice *dev,
+				      u32 *input, u32 len)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+	int ret;
+
+	ret = rk_crypto_sha_feed(dev, input, len);
+	if (ret)
+		return ret;
+
+	return rk_hash_dma_wait(priv);
+}
+
+static int rockchip_crypto_sha_update_async(struct udevice *dev,
+					    u32 *input, u32 len)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+	int ret;
+
+	priv->hw_ctx->async = 1;
+	ret = rk_crypto_sha_feed(dev, input, len);
+	priv->hw_ctx->async = 0;
+
+	return ret;
+}
+
+static int rockchip_crypto_wait(struct udevice *dev)
+{
+	struct rockchip_crypto_priv *priv = dev_get_priv(dev);
+
+	return rk_hash_dma_wait(priv);
+}
+
 static int rockchip_crypto_sha_final(struct udevice *dev,
 				     sha_context *ctx, u8 *output)
 {
@@ -572,6 +639,10 @@ static int rockchip_crypto_sha_final(struct udevice *dev,
 
 	nbits = crypto_algo_nbits(ctx->algo);
 
+	ret = rk_hash_dma_wait(priv);
+	if (ret)
+		goto exit;
+
 	if (priv->length != ctx->length) {
 		printf("total length(0x%08x) != init length(0x%08x)!\n",
 		       priv->length, ctx->length);
@@ -618,6 +689,9 @@ static int rockchip_crypto_hmac_init(struct udevice *dev,
 	if (!ctx)
 		return -EINVAL;
 
+	/* A digest abandoned mid-way may still have its last chunk in flight */
+	rk_hash_dma_wait(priv);
+
 	memset(hash_ctx, 0x00, sizeof(*hash_ctx));
 
 	priv->length = 0;
@@ -1332,6 +1406,8 @@ static const struct dm_crypto_ops rockchip_crypto_ops = {
 	.sha_init     = rockchip_crypto_sha_init,
 	.sha_update   = rockchip_crypto_sha_update,
 	.sha_final    = rockchip_crypto_sha_final,
+	.sha_update_async = rockchip_crypto_sha_update_async,
+	.wait         = rockchip_crypto_wait,
 #if CONFIG_IS_ENABLED(ROCKCHIP_RSA)
 	.rsa_verify   = rockchip_crypto_rsa_verify,
 #endif
@@ -1885,6 +1885,7 @@ static int mmc_startup(struct mmc *mmc)
 			mmc->part_attr = ext_csd[EXT_CSD_PARTITIONS_ATTRIBUTE];
 		if (ext_csd[EXT_CSD_SEC_FEATURE_SUPPORT] & EXT_CSD_SEC_GB_CL_EN)
 			mmc->esr.mmc_can_trim = 1;
+		mmc->esr.erased_mem_cont = ext_csd[EXT_CSD_ERASED_MEM_CONT];
 
 		mmc->capacity_boot = ext_csd[EXT_CSD_BOOT_MULT] << 17;
 
@@ -20,6 +20,9 @@
 #ifdef CONFIG_NAND
 #include <linux/mtd/nand.h>
 #endif
+#ifdef CONFIG_ROCKCHIP_PRELOADER_ATAGS
+#include <asm/arch/rk_atags.h>
+#endif
 
 #define MTD_PART_NAND_HEAD		"mtdparts="
 #define MTD_ROOT_PART_NUM		"ubi.mtd="
@@ -33,6 +36,128 @@
 
 static int *mtd_map_blk_table;
 
+#ifdef CONFIG_ROCKCHIP_PRELOADER_ATAGS
+#define MTD_BLK_MAP_VERSION		1
+
+#ifdef CONFIG_SPL_BUILD
+/* Bad block status collected while scanning, handed off to U-Boot */
+static struct tag_mtd_blk_map mtd_map_export;
+static bool mtd_map_export_overflow;
+
+static void mtd_blk_map_export_range(u32 blk_begin, u32 blk_cnt)
+{
+	struct tag_mtd_blk_map *map = &mtd_map_export;
+
+	if (map->range_cnt >= MTD_BLK_MAP_RANGE_MAX) {
+		mtd_map_export_overflow = true;
+		return;
+	}
+
+	map->range[map->range_cnt].begin = blk_begin;
+	map->range[map->range_cnt].cnt = blk_cnt;
+	map->range_cnt++;
+}
+
+static void mtd_blk_map_export_bad(u32 blk)
+{
+	struct tag_mtd_blk_map *map = &mtd_map_export;
+
+	if (map->bad_cnt >= MTD_BLK_MAP_BAD_MAX) {
+		mtd_map_export_overflow = true;
+		return;
+	}
+
+	map->bad[map->bad_cnt++] = blk;
+}
+
+static void mtd_blk_map_export(struct blk_desc *desc)
+{
+	struct tag_mtd_blk_map *map = &mtd_map_export;
+	struct mtd_info *mtd = desc->bdev->priv;
+
+	if (mtd_map_export_overflow || !map->range_cnt)
+		return;
+
+	map->version = MTD_BLK_MAP_VERSION;
+	map->devnum = desc->devnum;
+	map->erasesize_shift = mtd->erasesize_shift;
+	map->blk_total = (mtd->size + mtd->erasesize - 1) >> mtd->erasesize_shift;
+	if (atags_set_tag(ATAG_MTD_BLK_MAP, map))
+		debug("mtd_blk: set map tag failed\n");
+}
+#else
+/* Bad block status scanned by SPL, if it matches the current device */
+static struct tag_mtd_blk_map *mtd_map_import;
+
+static void mtd_blk_map_import(struct blk_desc *desc, u32 blk_total)
+{
+	struct mtd_info *mtd = desc->bdev->priv;
+	struct tag_mtd_blk_map *map;
+	struct tag *t;
+
+	t = atags_get_tag(ATAG_MTD_BLK_MAP);
+	if (!t)
+		return;
+
+	map = &t->u.mtd_blk_map;
+	if (map->version != MTD_BLK_MAP_VERSION ||
+	    map->devnum != desc->devnum ||
+	    map->erasesize_shift != mtd->erasesize_shift ||
+	    map->blk_total != blk_total ||
+	    map->range_cnt > MTD_BLK_MAP_RANGE_MAX ||
+	    map->bad_cnt > MTD_BLK_MAP_BAD_MAX)
+		return;
+
+	mtd_map_import = map;
+	debug("mtd_blk: adopt %d ranges, %d bad blocks from SPL\n",
+	      map->range_cnt, map->bad_cnt);
+}
+
+static int mtd_blk_map_import_isbad(u32 blk)
+{
+	struct tag_mtd_blk_map *map = mtd_map_import;
+	int i;
+
+	for (i = 0; i < map->range_cnt; i++) {
+		if (blk >= map->range[i].begin &&
+		    blk < map->range[i].begin + map->range[i].cnt)
+			break;
+	}
+
+	/* Not scanned by SPL */
+	if (i == map->range_cnt)
+		return -ENOENT;
+
+	for (i = 0; i < map->bad_cnt; i++) {
+		if (map->bad[i] == blk)
+			return 1;
+	}
+
+	return 0;
+}
+#endif
+#endif
+
+static int mtd_blk_isbad(struct mtd_info *mtd, u32 blk)
+{
+	int ret;
+
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && !defined(CONFIG_SPL_BUILD)
+	if (mtd_map_import) {
+		ret = mtd_blk_map_import_isbad(blk);
+		if (ret >= 0)
+			return ret;
+	}
+#endif
+	ret = mtd_block_isbad(mtd, (loff_t)blk << mtd->erasesize_shift);
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && defined(CONFIG_SPL_BUILD)
+	if (ret)
+		mtd_blk_map_export_bad(blk);
+#endif
+
+	return ret;
+}
+
 int mtd_blk_map_table_init(struct blk_desc *desc,
 			   loff_t offset,
 			   size_t length)
@@ -63,6 +188,9 @@ int mtd_blk_map_table_init(struct blk_desc *desc,
 				return -ENOMEM;
 			for (i = 0; i < blk_total; i++)
 				mtd_map_blk_table[i] = MTD_BLK_TABLE_BLOCK_UNKNOWN;
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && !defined(CONFIG_SPL_BUILD)
+			mtd_blk_map_import(desc, blk_total);
+#endif
 		}
 
 		blk_begin = (u32)offset >> mtd->erasesize_shift;
@@ -78,13 +206,16 @@ int mtd_blk_map_table_init(struct blk_desc *desc,
 		if (mtd_map_blk_table[blk_begin] != MTD_BLK_TABLE_BLOCK_UNKNOWN)
 			return 0;
 
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && defined(CONFIG_SPL_BUILD)
+		mtd_blk_map_export_range(blk_begin, blk_cnt);
+#endif
 		j = 0;
 		 /* should not across blk_cnt */
 		for (i = 0; i < blk_cnt; i++) {
 			if (j >= blk_cnt)
 				mtd_map_blk_table[blk_begin + i] = MTD_BLK_TABLE_BLOCK_SHIFT;
 			for (; j < blk_cnt; j++) {
-				if (!mtd_block_isbad(mtd, (blk_begin + j) << mtd->erasesize_shift)) {
+				if (!mtd_blk_isbad(mtd, blk_begin + j)) {
 					mtd_map_blk_table[blk_begin + i] = blk_begin + j;
 					j++;
 					if (j == blk_cnt)
@@ -141,6 +272,10 @@ void mtd_blk_map_partitions(struct blk_desc *desc)
 			pr_debug("mtd block map table fail\n");
 		}
 	}
+
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && defined(CONFIG_SPL_BUILD)
+	mtd_blk_map_export(desc);
+#endif
 }
 
 void mtd_blk_map_fit(struct blk_desc *desc, ulong sector, void *fit)
@@ -168,9 +303,41 @@ void mtd_blk_map_fit(struct blk_desc *desc, ulong sector, void *fit)
 	if (mtd && totalsize) {
 		if (mtd_blk_map_table_init(desc, sector << 9, totalsize + (size_t)mtd->erasesize))
 			debug("Map block table fail.\n");
+#if defined(CONFIG_ROCKCHIP_PRELOADER_ATAGS) && defined(CONFIG_SPL_BUILD)
+		mtd_blk_map_export(desc);
+#endif
 	}
 }
 
+/*
+ * Grow a mapped read of @len bytes at @offset over the following logical
+ * blocks as long as they map to physically consecutive blocks, so that a
+ * whole partition without bad blocks is fetched with a single mtd_read().
+ */
+static size_t mtd_map_contig_length(struct mtd_info *mtd, loff_t offset,
+				    loff_t mapped_offset, size_t len,
+				    size_t left)
+{
+	loff_t next, next_mapped;
+	size_t step;
+
+	while (len < left) {
+		next = offset + len;
+		next_mapped = next;
+		if (next >= mtd->size ||
+		    !get_mtd_blk_map_address(mtd, &next_mapped) ||
+		    next_mapped != mapped_offset + len)
+			break;
+
+		step = left - len;
+		if (step > mtd->erasesize)
+			step = mtd->erasesize;
+		len += step;
+	}
+
+	return len;
+}
+
 static __maybe_unused int mtd_map_read(struct mtd_info *mtd, loff_t offset,
 				       size_t *length, size_t *actual,
 				       loff_t lim, u_char *buffer)
@@ -183,6 +350,7 @@ static __maybe_unused int mtd_map_read(struct mtd_info *mtd, loff_t offset,
 		size_t block_offset = offset & (mtd->erasesize - 1);
 		size_t read_length;
 		loff_t mapped_offset;
+		bool mapped;
 
 		if (offset >= mtd->size)
 			return 0;
@@ -196,6 +364,9 @@ static __maybe_unused int mtd_map_read(struct mtd_info *mtd, loff_t offset,
 				offset += mtd->erasesize - block_offset;
 				continue;
 			}
+			mapped = false;
+		} else {
+			mapped = true;
 		}
 
 		if (left_to_read < (mtd->erasesize - block_offset))
@@ -203,6 +374,12 @@ static __maybe_unused int mtd_map_read(struct mtd_info *mtd, loff_t offset,
 		else
 			read_length = mtd->erasesize - block_offset;
 
+		if (mapped)
+			read_length = mtd_map_contig_length(mtd, offset,
+							    mapped_offset,
+							    read_length,
+							    left_to_read);
+
 		rval = mtd_read(mtd, mapped_offset, read_length, &read_length,
 				p_buffer);
 		if (rval && rval != -EUCLEAN) {
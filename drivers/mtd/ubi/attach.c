@@ -829,6 +829,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
+	ubi_io_read_hdrs(ubi, pnum);
 	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
 	if (err < 0)
 		return err;
@@ -1210,6 +1211,29 @@ static void destroy_ai(struct ubi_attach_info *ai)
 	kfree(ai);
 }
 
+/**
+ * hdrs_cache_init - set up reading both headers of a PEB at once.
+ * @ubi: UBI device description object
+ *
+ * Both headers are read with one MTD read from the start of the PEB, whether
+ * they share a page or, as on SPI-NAND without subpages, the VID header sits
+ * in the next page, which saves an MTD request per PEB.
+ */
+static void hdrs_cache_init(struct ubi_device *ubi)
+{
+	ubi->hdrs_pnum = -1;
+	ubi->hdrs_len = ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize;
+	ubi->hdrs_buf = kmalloc(ubi->hdrs_len, GFP_KERNEL);
+}
+
+static void hdrs_cache_exit(struct ubi_device *ubi)
+{
+	kfree(ubi->hdrs_buf);
+	ubi->hdrs_buf = NULL;
+	ubi->hdrs_pnum = -1;
+	ubi->hdrs_len = 0;
+}
+
 /**
  * scan_all - scan entire MTD device.
  * @ubi: UBI device description object
@@ -1238,6 +1262,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (!vidh)
 		goto out_ech;
 
+	hdrs_cache_init(ubi);
 	for (pnum = start; pnum < ubi->peb_count; pnum++) {
 		cond_resched();
 
@@ -1246,6 +1271,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		if (err < 0)
 			goto out_vidh;
 	}
+	hdrs_cache_exit(ubi);
 
 	ubi_msg(ubi, "scanning is finished");
 
@@ -1290,6 +1316,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	return 0;
 
 out_vidh:
+	hdrs_cache_exit(ubi);
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
@@ -1347,6 +1374,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	if (!vidh)
 		goto out_ech;
 
+	hdrs_cache_init(ubi);
 	for (pnum = 0; pnum < UBI_FM_MAX_START; pnum++) {
 		int vol_id = -1;
 		unsigned long long sqnum = -1;
@@ -1362,6 +1390,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 			fm_anchor = pnum;
 		}
 	}
+	hdrs_cache_exit(ubi);
 
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
@@ -1377,6 +1406,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	return ubi_scan_fastmap(ubi, *ai, fm_anchor);
 
 out_vidh:
+	hdrs_cache_exit(ubi);
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
@@ -1398,11 +1428,14 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 {
 	int err;
 	struct ubi_attach_info *ai;
+	unsigned long start = get_timer(0);
 
 	ai = alloc_ai();
 	if (!ai)
 		return -ENOMEM;
 
+	ubi->attach_scanned = 1;
+
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	/* On small flash devices we disable fastmap in any case. */
 	if ((int)mtd_div_by_eb(ubi->mtd->size, ubi->mtd) <= UBI_FM_MAX_START) {
@@ -1421,10 +1454,17 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 				if (!ai)
 					return -ENOMEM;
 
+				/*
+				 * The image carries a fastmap, so write a
+				 * fresh one once attached by scanning.
+				 */
+				ubi->fm_disabled = 0;
 				err = scan_all(ubi, ai, 0);
 			} else {
 				err = scan_all(ubi, ai, UBI_FM_MAX_START);
 			}
+		} else if (!err) {
+			ubi->attach_scanned = 0;
 		}
 	}
 #else
@@ -1477,6 +1517,11 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 #endif
 
 	destroy_ai(ai);
+	ubi->attach_time = get_timer(start);
+	ubi_msg(ubi, "attached by %s in %lu ms",
+		ubi->attach_scanned ? "scanning" : "fastmap",
+		ubi->attach_time);
+
 	return 0;
 
 out_wl:
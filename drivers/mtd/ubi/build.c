@@ -1065,6 +1065,15 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 
 	spin_unlock(&ubi->wl_lock);
 
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	/* Save the scan result so that the next attach can use fastmap */
+	if (ubi->attach_scanned && !ubi->fm_disabled) {
+		err = ubi_update_fastmap(ubi);
+		if (err)
+			ubi_warn(ubi, "failed to write fastmap, error %d", err);
+	}
+#endif
+
 	ubi_devices[ubi_num] = ubi;
 	ubi_notify_all(ubi, UBI_VOLUME_ADDED, NULL);
 	return ubi_num;
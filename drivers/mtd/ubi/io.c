@@ -155,6 +155,11 @@ int ubi_io_read(const struct ubi_device *ubi, void *buf, int pnum, int offset,
 	 */
 	*((uint8_t *)buf) ^= 0xFF;
 
+	if (pnum == ubi->hdrs_pnum && offset + len <= ubi->hdrs_len) {
+		memcpy(buf, ubi->hdrs_buf + offset, len);
+		return 0;
+	}
+
 	addr = (loff_t)pnum * ubi->peb_size + offset;
 retry:
 	err = mtd_read(ubi->mtd, addr, len, &read, buf);
@@ -208,6 +213,34 @@ retry:
 	return err;
 }
 
+/**
+ * ubi_io_read_hdrs - read the EC and VID headers of a PEB in one go.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock number to read from
+ *
+ * This function is used while scanning a PEB already known not to be bad. It
+ * reads both headers with a single MTD read into @ubi->hdrs_buf, so that the
+ * following ubi_io_read() calls for the headers of @pnum do not go to the
+ * flash again. Anything but a clean read leaves the cache empty and the
+ * headers are then read (and their errors handled) the usual way.
+ */
+void ubi_io_read_hdrs(struct ubi_device *ubi, int pnum)
+{
+	size_t read;
+	int err;
+
+	ubi->hdrs_pnum = -1;
+	if (!ubi->hdrs_buf)
+		return;
+
+	err = mtd_read(ubi->mtd, (loff_t)pnum * ubi->peb_size, ubi->hdrs_len,
+		       &read, ubi->hdrs_buf);
+	if (err || read != ubi->hdrs_len || ubi_dbg_is_bitflip(ubi))
+		return;
+
+	ubi->hdrs_pnum = pnum;
+}
+
 /**
  * ubi_io_write - write data to a physical eraseblock.
  * @ubi: UBI device description object
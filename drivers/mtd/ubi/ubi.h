@@ -525,6 +525,13 @@ struct ubi_debug_info {
  * @buf_mutex: protects @peb_buf
  * @ckvol_mutex: serializes static volume checking when opening
  *
+ * @hdrs_buf: EC and VID headers of PEB @hdrs_pnum read with one MTD read while
+ *            scanning
+ * @hdrs_len: how many bytes of @hdrs_buf are valid
+ * @hdrs_pnum: PEB cached in @hdrs_buf, or %-1 if none
+ * @attach_time: time spent in ubi_attach() in milliseconds
+ * @attach_scanned: non-zero if the device was attached by full scanning
+ *
  * @dbg: debugging information for this UBI device
  */
 struct ubi_device {
@@ -624,6 +631,12 @@ struct ubi_device {
 	struct mutex buf_mutex;
 	struct mutex ckvol_mutex;
 
+	void *hdrs_buf;
+	int hdrs_len;
+	int hdrs_pnum;
+	unsigned long attach_time;
+	int attach_scanned;
+
 	struct ubi_debug_info dbg;
 };
 
@@ -882,6 +895,7 @@ int ubi_ensure_anchor_pebs(struct ubi_device *ubi);
 /* io.c */
 int ubi_io_read(const struct ubi_device *ubi, void *buf, int pnum, int offset,
 		int len);
+void ubi_io_read_hdrs(struct ubi_device *ubi, int pnum);
 int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 		 int len);
 int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture);
@@ -13,7 +13,7 @@
 #endif
 
 #define CONFIG_TX_DESCR_NUM	16
-#define CONFIG_RX_DESCR_NUM	16
+#define CONFIG_RX_DESCR_NUM	32
 #define CONFIG_ETH_BUFSIZE	2048
 #define TX_TOTAL_BUFSIZE	(CONFIG_ETH_BUFSIZE * CONFIG_TX_DESCR_NUM)
 #define RX_TOTAL_BUFSIZE	(CONFIG_ETH_BUFSIZE * CONFIG_RX_DESCR_NUM)
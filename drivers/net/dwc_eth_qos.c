@@ -234,7 +234,19 @@ struct eqos_tegra186_regs {
 /* We assume ARCH_DMA_MINALIGN >= 16; 16 is the EQOS HW minimum */
 #define EQOS_DESCRIPTOR_ALIGN	ARCH_DMA_MINALIGN
 #define EQOS_DESCRIPTORS_TX	4
+/*
+ * Windowed TFTP or fastboot bursts arrive back to back at line rate, so give
+ * RX a deeper ring when descriptors live in non-cached memory. With cached
+ * descriptors several of them share a cache line and the ring is kept at
+ * its original size.
+ */
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+#define EQOS_DESCRIPTORS_RX	32
+#else
 #define EQOS_DESCRIPTORS_RX	4
+#endif
+/* Requeued RX descriptors handed back to the DMA with one tail update */
+#define EQOS_RX_REFILL_BATCH	(EQOS_DESCRIPTORS_RX / 4)
 #define EQOS_DESCRIPTORS_NUM	(EQOS_DESCRIPTORS_TX + EQOS_DESCRIPTORS_RX)
 #define EQOS_DESCRIPTORS_SIZE	ALIGN(EQOS_DESCRIPTORS_NUM * \
 				      EQOS_DESCRIPTOR_SIZE, ARCH_DMA_MINALIGN)
@@ -1267,6 +1279,8 @@ void eqos_enable(struct udevice *dev)
 
 	eqos->tx_desc_idx = 0;
 	eqos->rx_desc_idx = 0;
+	eqos->rx_refill_desc = NULL;
+	eqos->rx_refill_cnt = 0;
 
 	/* Configure MTL */
 	writel(0x60, &eqos->mtl_regs->txq0_quantum_weight - 0x100);
@@ -1598,6 +1612,21 @@ int eqos_send(struct udevice *dev, void *packet, int length)
 	return -ETIMEDOUT;
 }
 
+/*
+ * Move the RX tail pointer past all descriptors requeued by eqos_free_pkt()
+ * since the last update, so a burst costs one register write per batch.
+ */
+static void eqos_rx_refill(struct eqos_priv *eqos)
+{
+	if (!eqos->rx_refill_desc)
+		return;
+
+	writel((ulong)eqos->rx_refill_desc,
+	       &eqos->dma_regs->ch0_rxdesc_tail_pointer);
+	eqos->rx_refill_desc = NULL;
+	eqos->rx_refill_cnt = 0;
+}
+
 int eqos_recv(struct udevice *dev, int flags, uchar **packetp)
 {
 	struct eqos_priv *eqos = dev_get_priv(dev);
@@ -1610,6 +1639,8 @@ int eqos_recv(struct udevice *dev, int flags, uchar **packetp)
 	eqos->config->ops->eqos_inval_desc(rx_desc);
 	if (rx_desc->des3 & EQOS_DESC3_OWN) {
 		debug("%s: RX packet not available\n", __func__);
+		/* Ring drained, return what we consumed to the DMA */
+		eqos_rx_refill(eqos);
 		return -EAGAIN;
 	}
 
@@ -1639,8 +1670,6 @@ int eqos_free_pkt(struct udevice *dev, uchar *packet, int length)
 		return -EINVAL;
 	}
 
-	eqos->config->ops->eqos_inval_buffer(packet, length);
-
 	rx_desc = &(eqos->rx_descs[eqos->rx_desc_idx]);
 
 	rx_desc->des0 = 0;
@@ -1658,7 +1687,9 @@ int eqos_free_pkt(struct udevice *dev, uchar *packet, int length)
 	rx_desc->des3 = EQOS_DESC3_OWN | EQOS_DESC3_BUF1V;
 	eqos->config->ops->eqos_flush_desc(rx_desc);
 
-	writel((ulong)rx_desc, &eqos->dma_regs->ch0_rxdesc_tail_pointer);
+	eqos->rx_refill_desc = rx_desc;
+	if (++eqos->rx_refill_cnt >= EQOS_RX_REFILL_BATCH)
+		eqos_rx_refill(eqos);
 
 	eqos->rx_desc_idx++;
 	eqos->rx_desc_idx %= EQOS_DESCRIPTORS_RX;
@@ -69,6 +69,8 @@ struct eqos_priv {
 	struct eqos_desc *tx_descs;
 	struct eqos_desc *rx_descs;
 	int tx_desc_idx, rx_desc_idx;
+	struct eqos_desc *rx_refill_desc;
+	int rx_refill_cnt;
 	void *tx_dma_buf;
 	void *rx_dma_buf;
 	void *rx_pkt;
@@ -13,7 +13,7 @@
 #include <dm/device-internal.h>
 #include "nvme.h"
 
-#define NVME_Q_DEPTH		2
+#define NVME_Q_DEPTH		32
 #define NVME_AQ_DEPTH		2
 #define NVME_SQ_SIZE(depth)	(depth * sizeof(struct nvme_command))
 #define NVME_CQ_SIZE(depth)	(depth * sizeof(struct nvme_completion))
@@ -21,7 +21,6 @@
 				      ARCH_DMA_MINALIGN)
 #define ADMIN_TIMEOUT		60
 #define IO_TIMEOUT		30
-#define MAX_PRP_POOL		512
 
 enum nvme_queue_id {
 	NVME_ADMIN_Q,
@@ -68,8 +67,8 @@ static int nvme_wait_ready(struct nvme_dev *dev, bool enabled)
 	return -ETIME;
 }
 
-static int nvme_setup_prps(struct nvme_dev *dev, u64 *prp2,
-			   int total_len, u64 dma_addr)
+static int nvme_setup_prps(struct nvme_dev *dev, struct nvme_io_slot *slot,
+			   u64 *prp2, int total_len, u64 dma_addr)
 {
 	u32 page_size = dev->page_size;
 	int offset = dma_addr & (page_size - 1);
@@ -95,23 +94,25 @@ static int nvme_setup_prps(struct nvme_dev *dev, u64 *prp2,
 	}
 
 	nprps = DIV_ROUND_UP(length, page_size);
-	num_pages = DIV_ROUND_UP(nprps + 1, prps_per_page);
+	/* The last entry of every page but the last one chains to the next */
+	num_pages = DIV_ROUND_UP(nprps - 1, prps_per_page - 1);
 
-	if (nprps > dev->prp_entry_num) {
-		free(dev->prp_pool);
+	if (num_pages > slot->prp_pages) {
+		free(slot->prp_list);
+		slot->prp_pages = 0;
 		/*
 		 * Always increase in increments of pages.  It doesn't waste
 		 * much memory and reduces the number of allocations.
 		 */
-		dev->prp_pool = memalign(page_size, num_pages * page_size);
-		if (!dev->prp_pool) {
+		slot->prp_list = memalign(page_size, num_pages * page_size);
+		if (!slot->prp_list) {
 			printf("Error: malloc prp_pool fail\n");
 			return -ENOMEM;
 		}
-		dev->prp_entry_num = prps_per_page * num_pages;
+		slot->prp_pages = num_pages;
 	}
 
-	prp_pool = dev->prp_pool;
+	prp_pool = slot->prp_list;
 	i = 0;
 	while (nprps) {
 		if (i == prps_per_page) {
@@ -119,16 +120,16 @@ static int nvme_setup_prps(struct nvme_dev *dev, u64 *prp2,
 			*(prp_pool + i - 1) = cpu_to_le64((ulong)prp_pool +
 					page_size);
 			i = 1;
-			prp_pool += page_size;
+			prp_pool += prps_per_page;
 		}
 		*(prp_pool + i++) = cpu_to_le64(dma_addr);
 		dma_addr += page_size;
 		nprps--;
 	}
-	*prp2 = (ulong)dev->prp_pool;
+	*prp2 = (ulong)slot->prp_list;
 
-	flush_dcache_range((ulong)dev->prp_pool, (ulong)dev->prp_pool +
-			   dev->prp_entry_num * sizeof(u64));
+	flush_dcache_range((ulong)slot->prp_list, (ulong)slot->prp_list +
+			   num_pages * page_size);
 
 	return 0;
 }
@@ -176,9 +177,19 @@ static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
 	nvmeq->sq_tail = tail;
 }
 
-static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
-				struct nvme_command *cmd,
-				u32 *result, unsigned timeout)
+/**
+ * nvme_reap_cmd() - wait for the next completion and consume it
+ *
+ * @nvmeq:	The queue to poll
+ * @result:	Place to put the command specific result, may be NULL
+ * @cmdid:	Place to put the identifier of the completed command,
+ *		may be NULL
+ * @timeout:	Timeout, in the same units as nvme_submit_sync_cmd()
+ * @return 0 on success, -ETIMEDOUT if nothing completed in time, -EIO if
+ * the completed command failed
+ */
+static int nvme_reap_cmd(struct nvme_queue *nvmeq, u32 *result, u16 *cmdid,
+			 unsigned timeout)
 {
 	u16 head = nvmeq->cq_head;
 	u16 phase = nvmeq->cq_phase;
@@ -186,9 +197,6 @@ static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
 	ulong start_time;
 	ulong timeout_us = timeout * 100000;
 
-	cmd->common.command_id = nvme_get_cmd_id();
-	nvme_submit_cmd(nvmeq, cmd);
-
 	start_time = timer_get_us();
 
 	for (;;) {
@@ -200,6 +208,9 @@ static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
 			return -ETIMEDOUT;
 	}
 
+	if (cmdid)
+		*cmdid = readw(&(nvmeq->cqes[head].command_id));
+
 	status >>= 1;
 	if (status) {
 		printf("ERROR: status = %x, phase = %d, head = %d\n",
@@ -230,6 +241,16 @@ static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
 	return status;
 }
 
+static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
+				struct nvme_command *cmd,
+				u32 *result, unsigned timeout)
+{
+	cmd->common.command_id = nvme_get_cmd_id();
+	nvme_submit_cmd(nvmeq, cmd);
+
+	return nvme_reap_cmd(nvmeq, result, NULL, timeout);
+}
+
 static int nvme_submit_admin_cmd(struct nvme_dev *dev, struct nvme_command *cmd,
 				 u32 *result)
 {
@@ -640,17 +661,14 @@ static int nvme_get_info_from_identify(struct nvme_dev *dev)
 		 * and is reported as a power of two (2^n).
 		 *
 		 * The spec also says: a value of 0h indicates no restrictions
-		 * on transfer size. But in nvme_blk_read/write() below we have
-		 * the following algorithm for maximum number of logic blocks
-		 * per transfer:
-		 *
-		 * u16 lbas = 1 << (dev->max_transfer_shift - ns->lba_shift);
-		 *
-		 * In order for lbas not to overflow, the maximum number is 15
-		 * which means dev->max_transfer_shift = 15 + 9 (ns->lba_shift).
-		 * Let's use 20 which provides 1MB size.
+		 * on transfer size. We still need a bound for the PRP lists
+		 * of the commands in flight, and the NLB field of a read/write
+		 * command limits one command to 65536 blocks anyway, which
+		 * nvme_max_lbas() takes care of. Let's use 22 which provides
+		 * 4MB size, so that a kernel image is read with a handful of
+		 * commands.
 		 */
-		dev->max_transfer_shift = 20;
+		dev->max_transfer_shift = 22;
 	}
 
 	free(ctrl);
@@ -729,68 +747,202 @@ static int nvme_blk_probe(struct udevice *udev)
 	return 0;
 }
 
-static ulong nvme_blk_rw(struct udevice *udev, lbaint_t blknr,
-			 lbaint_t blkcnt, void *buffer, bool read)
+static u32 nvme_max_lbas(struct nvme_ns *ns)
+{
+	u32 shift = ns->dev->max_transfer_shift - ns->lba_shift;
+
+	/* The 0's based NLB field of a read/write command is 16 bits wide */
+	return 1 << min_t(u32, shift, 16);
+}
+
+static void nvme_io_fail(struct nvme_io_req *req, u64 slba)
+{
+	req->fail_lba = min(req->fail_lba, slba);
+	req->todo = 0;
+}
+
+/* Issue commands for the queued requests while there are free I/O slots */
+static void nvme_io_kick(struct nvme_dev *dev)
+{
+	struct nvme_queue *nvmeq = dev->queues[NVME_IO_Q];
+	int max_inflight = min(NVME_IO_SLOTS, nvmeq->q_depth - 1);
+	struct nvme_io_slot *slot;
+	struct nvme_io_req *req;
+	struct nvme_command c;
+	u64 prp2;
+	u32 lbas;
+	int i, r;
+
+	for (r = 0; r < NVME_IO_REQS; r++) {
+		req = &dev->io_reqs[r];
+
+		while (req->busy && req->todo && dev->io_inflight < max_inflight) {
+			for (i = 0; dev->io_slots[i].req; i++)
+				;
+			slot = &dev->io_slots[i];
+
+			lbas = min_t(u64, req->todo, nvme_max_lbas(req->ns));
+			if (nvme_setup_prps(dev, slot, &prp2,
+					    lbas << req->ns->lba_shift,
+					    (ulong)req->next_buf)) {
+				nvme_io_fail(req, req->next_lba);
+				break;
+			}
+
+			slot->gen = (slot->gen + 1) % NVME_IO_GENS;
+
+			memset(&c, 0, sizeof(c));
+			c.rw.opcode = req->read ? nvme_cmd_read : nvme_cmd_write;
+			c.rw.command_id = cpu_to_le16(slot->gen * NVME_IO_SLOTS + i);
+			c.rw.nsid = cpu_to_le32(req->ns->ns_id);
+			c.rw.slba = cpu_to_le64(req->next_lba);
+			c.rw.length = cpu_to_le16(lbas - 1);
+			c.rw.prp1 = cpu_to_le64((ulong)req->next_buf);
+			c.rw.prp2 = cpu_to_le64(prp2);
+
+			/* Enable FUA for data integrity if vwc is enabled */
+			if (dev->vwc)
+				c.rw.control |= NVME_RW_FUA;
+
+			nvme_submit_cmd(nvmeq, &c);
+
+			slot->req = req;
+			slot->slba = req->next_lba;
+			req->next_lba += lbas;
+			req->next_buf += lbas << req->ns->lba_shift;
+			req->todo -= lbas;
+			req->inflight++;
+			dev->io_inflight++;
+		}
+	}
+}
+
+/* Wait for one I/O command to complete and account it to its request */
+static int nvme_io_reap(struct nvme_dev *dev)
+{
+	struct nvme_io_slot *slot;
+	u16 cmdid;
+	int ret, i;
+
+	ret = nvme_reap_cmd(dev->queues[NVME_IO_Q], NULL, &cmdid, IO_TIMEOUT);
+	if (ret == -ETIMEDOUT) {
+		/* Give up on everything that is still in flight */
+		for (i = 0; i < NVME_IO_SLOTS; i++) {
+			slot = &dev->io_slots[i];
+			if (!slot->req)
+				continue;
+			nvme_io_fail(slot->req, slot->slba);
+			slot->req->inflight--;
+			slot->req = NULL;
+		}
+		dev->io_inflight = 0;
+
+		return ret;
+	}
+
+	cmdid = le16_to_cpu(cmdid);
+	slot = &dev->io_slots[cmdid % NVME_IO_SLOTS];
+	/* Ignore late completions of commands we already gave up on */
+	if (!slot->req || slot->gen != cmdid / NVME_IO_SLOTS)
+		return ret;
+
+	if (ret)
+		nvme_io_fail(slot->req, slot->slba);
+	slot->req->inflight--;
+	slot->req = NULL;
+	dev->io_inflight--;
+
+	return ret;
+}
+
+static int nvme_io_submit(struct udevice *udev, lbaint_t blknr,
+			  lbaint_t blkcnt, void *buffer, bool read)
 {
 	struct nvme_ns *ns = dev_get_priv(udev);
 	struct nvme_dev *dev = ns->dev;
-	struct nvme_command c;
 	struct blk_desc *desc = dev_get_uclass_platdata(udev);
-	int status;
-	u64 prp2;
-	u64 total_len = blkcnt << desc->log2blksz;
-	u64 temp_len = total_len;
+	struct nvme_io_req *req;
+	int r;
 
-	u64 slba = blknr;
-	u16 lbas = 1 << (dev->max_transfer_shift - ns->lba_shift);
-	u64 total_lbas = blkcnt;
+	for (r = 0; r < NVME_IO_REQS; r++)
+		if (!dev->io_reqs[r].busy)
+			break;
+	if (r == NVME_IO_REQS)
+		return -EBUSY;
+
+	req = &dev->io_reqs[r];
+	req->ns = ns;
+	req->buffer = buffer;
+	req->next_buf = buffer;
+	req->total_len = (u64)blkcnt << desc->log2blksz;
+	req->start_lba = blknr;
+	req->next_lba = blknr;
+	req->fail_lba = blknr + blkcnt;
+	req->todo = blkcnt;
+	req->inflight = 0;
+	req->read = read;
+	req->busy = true;
 
 	flush_dcache_range((unsigned long)buffer,
-			   (unsigned long)buffer + total_len);
-
-	c.rw.opcode = read ? nvme_cmd_read : nvme_cmd_write;
-	c.rw.flags = 0;
-	c.rw.nsid = cpu_to_le32(ns->ns_id);
-	c.rw.control = 0;
-	c.rw.dsmgmt = 0;
-	c.rw.reftag = 0;
-	c.rw.apptag = 0;
-	c.rw.appmask = 0;
-	c.rw.metadata = 0;
-
-	/* Enable FUA for data integrity if vwc is enabled */
-	if (dev->vwc)
-		c.rw.control |= NVME_RW_FUA;
-
-	while (total_lbas) {
-		if (total_lbas < lbas) {
-			lbas = (u16)total_lbas;
-			total_lbas = 0;
-		} else {
-			total_lbas -= lbas;
-		}
+			   (unsigned long)buffer + req->total_len);
+
+	nvme_io_kick(dev);
+
+	return r;
+}
+
+static ulong nvme_io_wait(struct nvme_dev *dev, int handle)
+{
+	struct nvme_io_req *req = &dev->io_reqs[handle];
 
-		if (nvme_setup_prps(dev, &prp2,
-				    lbas << ns->lba_shift, (ulong)buffer))
-			return -EIO;
-		c.rw.slba = cpu_to_le64(slba);
-		slba += lbas;
-		c.rw.length = cpu_to_le16(lbas - 1);
-		c.rw.prp1 = cpu_to_le64((ulong)buffer);
-		c.rw.prp2 = cpu_to_le64(prp2);
-		status = nvme_submit_sync_cmd(dev->queues[NVME_IO_Q],
-				&c, NULL, IO_TIMEOUT);
-		if (status)
+	while (req->todo || req->inflight) {
+		nvme_io_kick(dev);
+		if (!dev->io_inflight)
 			break;
-		temp_len -= (u32)lbas << ns->lba_shift;
-		buffer += lbas << ns->lba_shift;
+		nvme_io_reap(dev);
 	}
 
-	if (read)
-		invalidate_dcache_range((unsigned long)buffer,
-					(unsigned long)buffer + total_len);
+	if (req->read)
+		invalidate_dcache_range((unsigned long)req->buffer,
+					(unsigned long)req->buffer +
+					req->total_len);
+	req->busy = false;
+
+	return req->fail_lba - req->start_lba;
+}
+
+int nvme_blk_read_async(struct udevice *udev, lbaint_t blknr,
+			lbaint_t blkcnt, void *buffer)
+{
+	if (udev->driver != DM_GET_DRIVER(nvme_blk))
+		return -EINVAL;
+
+	return nvme_io_submit(udev, blknr, blkcnt, buffer, true);
+}
+
+ulong nvme_blk_wait(struct udevice *udev, int handle)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
 
-	return (total_len - temp_len) >> desc->log2blksz;
+	if (udev->driver != DM_GET_DRIVER(nvme_blk) ||
+	    handle < 0 || handle >= NVME_IO_REQS ||
+	    !ns->dev->io_reqs[handle].busy)
+		return 0;
+
+	return nvme_io_wait(ns->dev, handle);
+}
+
+static ulong nvme_blk_rw(struct udevice *udev, lbaint_t blknr,
+			 lbaint_t blkcnt, void *buffer, bool read)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
+	int handle;
+
+	handle = nvme_io_submit(udev, blknr, blkcnt, buffer, read);
+	if (handle < 0)
+		return 0;
+
+	return nvme_io_wait(ns->dev, handle);
 }
 
 static ulong nvme_blk_read(struct udevice *udev, lbaint_t blknr,
@@ -862,15 +1014,6 @@ static int nvme_probe(struct udevice *udev)
 	if (ret)
 		goto free_queue;
 
-	/* Allocate after the page size is known */
-	ndev->prp_pool = memalign(ndev->page_size, MAX_PRP_POOL);
-	if (!ndev->prp_pool) {
-		ret = -ENOMEM;
-		printf("Error: %s: Out of memory!\n", udev->name);
-		goto free_nvme;
-	}
-	ndev->prp_entry_num = MAX_PRP_POOL >> 3;
-
 	ret = nvme_setup_io_queues(ndev);
 	if (ret)
 		goto free_queue;
@@ -603,6 +603,45 @@ enum {
 	NVME_CSTS_SHST_MASK	= 3 << 2,
 };
 
+/* Number of I/O commands kept in flight on the I/O queue */
+#define NVME_IO_SLOTS		8
+/* Generations a slot counts through, so that gen:slot fits a command id */
+#define NVME_IO_GENS		(0x10000 / NVME_IO_SLOTS)
+/* Number of block requests that may be queued at the same time */
+#define NVME_IO_REQS		4
+
+/*
+ * A block read or write request. It is split into commands of at most
+ * the maximum data transfer size, which are issued through free I/O
+ * slots as earlier commands complete.
+ */
+struct nvme_io_req {
+	struct nvme_ns *ns;
+	void *buffer;		/* start of the caller's buffer */
+	void *next_buf;		/* buffer of the next command to issue */
+	u64 total_len;
+	u64 start_lba;
+	u64 next_lba;		/* first LBA of the next command to issue */
+	u64 fail_lba;		/* lowest LBA of a failed command */
+	u64 todo;		/* blocks not yet issued */
+	int inflight;		/* commands issued but not yet completed */
+	bool read;
+	bool busy;
+};
+
+/*
+ * An I/O command in flight. Its command identifier is
+ * gen * NVME_IO_SLOTS + slot index, so that a late completion of a command
+ * given up on does not match a later command in the same slot.
+ */
+struct nvme_io_slot {
+	struct nvme_io_req *req;
+	u64 slba;
+	u16 gen;		/* generation of the current command */
+	u64 *prp_list;		/* PRP list of this command */
+	u32 prp_pages;		/* pages allocated for @prp_list */
+};
+
 /* Represents an NVM Express device. Each nvme_dev is a PCI function. */
 struct nvme_dev {
 	struct list_head node;
@@ -625,9 +664,10 @@ struct nvme_dev {
 	u32 stripe_size;
 	u32 page_size;
 	u8 vwc;
-	u64 *prp_pool;
-	u32 prp_entry_num;
 	u32 nn;
+	struct nvme_io_slot io_slots[NVME_IO_SLOTS];
+	struct nvme_io_req io_reqs[NVME_IO_REQS];
+	int io_inflight;
 };
 
 /*
@@ -671,42 +671,170 @@ error:
 	return ret;
 }
 
+static int pci_bus_find_capability(struct udevice *bus, pci_dev_t bdf,
+				   int cap)
+{
+	int ttl = PCI_FIND_CAP_TTL;
+	ulong status, pos, id;
+
+	pci_bus_read_config(bus, bdf, PCI_STATUS, &status, PCI_SIZE_16);
+	if (!(status & PCI_STATUS_CAP_LIST))
+		return 0;
+
+	pci_bus_read_config(bus, bdf, PCI_CAPABILITY_LIST, &pos, PCI_SIZE_8);
+	while (ttl-- && pos >= CAP_START_POS) {
+		pos &= ~3;
+		pci_bus_read_config(bus, bdf, pos + PCI_CAP_LIST_ID, &id,
+				    PCI_SIZE_8);
+		if (id == 0xff)
+			break;
+		if (id == cap)
+			return pos;
+		pci_bus_read_config(bus, bdf, pos + PCI_CAP_LIST_NEXT, &pos,
+				    PCI_SIZE_8);
+	}
+
+	return 0;
+}
+
+static int pci_bus_find_ext_capability(struct udevice *bus, pci_dev_t bdf,
+				       int cap)
+{
+	int ttl = (PCI_CFG_SPACE_EXP_SIZE - PCI_CFG_SPACE_SIZE) / 8;
+	int pos = PCI_CFG_SPACE_SIZE;
+	ulong header;
+
+	while (ttl--) {
+		pci_bus_read_config(bus, bdf, pos, &header, PCI_SIZE_32);
+		if (header == 0xffffffff || header == 0)
+			break;
+		if (PCI_EXT_CAP_ID(header) == cap)
+			return pos;
+		pos = PCI_EXT_CAP_NEXT(header);
+		if (pos < PCI_CFG_SPACE_SIZE)
+			break;
+	}
+
+	return 0;
+}
+
+/*
+ * A bus below a PCIe Root Port or Downstream Port is a point-to-point link
+ * with a single device 0 on it, so there is no point in probing the other
+ * 31 device numbers. @arip is set if the port forwards ARI function numbers,
+ * in which case the functions of device 0 must be found from the ARI
+ * capability rather than the multi-function bit.
+ */
+static bool pci_bus_only_one_child(struct udevice *bus, bool *arip)
+{
+	pci_dev_t bdf;
+	ulong flags, ctl2;
+	int pos, type;
+
+	*arip = false;
+	if (!device_is_on_pci_bus(bus))
+		return false;
+
+	bdf = dm_pci_get_bdf(bus);
+	pos = pci_bus_find_capability(bus, bdf, PCI_CAP_ID_EXP);
+	if (!pos)
+		return false;
+
+	pci_bus_read_config(bus, bdf, pos + PCI_EXP_FLAGS, &flags, PCI_SIZE_16);
+	type = (flags & PCI_EXP_FLAGS_TYPE) >> 4;
+	if (type != PCI_EXP_TYPE_ROOT_PORT &&
+	    type != PCI_EXP_TYPE_DOWNSTREAM &&
+	    type != PCI_EXP_TYPE_PCIE_BRIDGE)
+		return false;
+
+	pci_bus_read_config(bus, bdf, pos + PCI_EXP_DEVCTL2, &ctl2,
+			    PCI_SIZE_16);
+	*arip = ctl2 & PCI_EXP_DEVCTL2_ARI;
+
+	return true;
+}
+
+/*
+ * Return the devfn of the next function of an ARI device, 0 if there is
+ * none, or -ENOENT if the device has no ARI capability.
+ */
+static int pci_bus_ari_next_fn(struct udevice *bus, pci_dev_t bdf)
+{
+	ulong cap;
+	int pos, next;
+
+	pos = pci_bus_find_ext_capability(bus, bdf, PCI_EXT_CAP_ID_ARI);
+	if (!pos)
+		return -ENOENT;
+
+	pci_bus_read_config(bus, bdf, pos + PCI_ARI_CAP, &cap, PCI_SIZE_16);
+	next = PCI_ARI_CAP_NFN(cap);
+
+	/* Function numbers must increase, don't follow a looping chain */
+	return next > PCI_MASK_BUS(bdf) >> 8 ? next : 0;
+}
+
 int pci_bind_bus_devices(struct udevice *bus)
 {
 	ulong vendor, device;
 	ulong header_type;
-	pci_dev_t bdf, end;
-	bool found_multi;
-	int ret;
+	pci_dev_t bdf, next, end;
+	bool found_multi, ari;
+	int ret, fn;
 
 	found_multi = false;
-	end = PCI_BDF(bus->seq, PCI_MAX_PCI_DEVICES - 1,
-		      PCI_MAX_PCI_FUNCTIONS - 1);
-	for (bdf = PCI_BDF(bus->seq, 0, 0); bdf <= end;
-	     bdf += PCI_BDF(0, 0, 1)) {
+	if (pci_bus_only_one_child(bus, &ari) && !ari)
+		end = PCI_BDF(bus->seq, 0, PCI_MAX_PCI_FUNCTIONS - 1);
+	else
+		end = PCI_BDF(bus->seq, PCI_MAX_PCI_DEVICES - 1,
+			      PCI_MAX_PCI_FUNCTIONS - 1);
+	for (bdf = PCI_BDF(bus->seq, 0, 0); bdf <= end; bdf = next) {
 		struct pci_child_platdata *pplat;
 		struct udevice *dev;
 		ulong class;
 
-		if (PCI_FUNC(bdf) && !found_multi)
+		next = bdf + PCI_BDF(0, 0, 1);
+		if (PCI_FUNC(bdf) && !found_multi && !ari)
 			continue;
 		/* Check only the first access, we don't expect problems */
-		ret = pci_bus_read_config(bus, bdf, PCI_HEADER_TYPE,
-					  &header_type, PCI_SIZE_8);
+		ret = pci_bus_read_config(bus, bdf, PCI_VENDOR_ID, &vendor,
+					  PCI_SIZE_32);
 		if (ret)
 			goto error;
-		pci_bus_read_config(bus, bdf, PCI_VENDOR_ID, &vendor,
-				    PCI_SIZE_16);
-		if (vendor == 0xffff || vendor == 0x0000)
+		device = vendor >> 16;
+		vendor &= 0xffff;
+		if (vendor == 0xffff || vendor == 0x0000) {
+			/* Without function 0 there are no other functions */
+			if (!PCI_FUNC(bdf)) {
+				if (ari)
+					break;
+				found_multi = false;
+				next = PCI_BDF(bus->seq, PCI_DEV(bdf) + 1, 0);
+			}
 			continue;
+		}
 
+		pci_bus_read_config(bus, bdf, PCI_HEADER_TYPE, &header_type,
+				    PCI_SIZE_8);
 		if (!PCI_FUNC(bdf))
 			found_multi = header_type & 0x80;
 
+		if (ari) {
+			fn = pci_bus_ari_next_fn(bus, bdf);
+			if (fn > 0) {
+				next = PCI_ADD_BUS(bus->seq, fn << 8);
+			} else if (!fn) {
+				next = end + 1;
+			} else {
+				/* Not an ARI device, use the multi-function bit */
+				ari = false;
+				end = PCI_BDF(bus->seq, 0,
+					      PCI_MAX_PCI_FUNCTIONS - 1);
+			}
+		}
+
 		debug("%s: bus %d/%s: found device %x, function %d\n", __func__,
 		      bus->seq, bus->name, PCI_DEV(bdf), PCI_FUNC(bdf));
-		pci_bus_read_config(bus, bdf, PCI_DEVICE_ID, &device,
-				    PCI_SIZE_16);
 		pci_bus_read_config(bus, bdf, PCI_CLASS_REVISION, &class,
 				    PCI_SIZE_32);
 		class >>= 8;
@@ -1278,14 +1406,27 @@ U_BOOT_DRIVER(pci_generic_drv) = {
 void pci_init(void)
 {
 	struct udevice *bus;
+	struct uclass *uc;
+	int ret;
+
+	ret = uclass_get(UCLASS_PCI, &uc);
+	if (ret)
+		return;
 
 	/*
 	 * Enumerate all known controller devices. Enumeration has the side-
 	 * effect of probing them, so PCIe devices will be enumerated too.
+	 * Buses probed by an earlier call already describe their topology and
+	 * are skipped, while a controller that failed (e.g. its link was not
+	 * up yet) is tried again without stopping at it.
 	 */
-	for (uclass_first_device(UCLASS_PCI, &bus);
-	     bus;
-	     uclass_next_device(&bus)) {
-		;
+	uclass_foreach_dev(bus, uc) {
+		if (device_active(bus))
+			continue;
+
+		ret = device_probe(bus);
+		if (ret)
+			debug("%s: probe %s failed: %d\n", __func__,
+			      bus->name, ret);
 	}
 }
@@ -37,6 +37,9 @@ struct rk_pcie {
 	struct pci_region	mem;
 	bool		is_bifurcation;
 	u32 gen;
+	u32		num_ob_windows;
+	u32		cfg_atu_type;	/* 0 if region 1 does not map config */
+	pci_dev_t	cfg_atu_bdf;
 };
 
 enum {
@@ -97,6 +100,7 @@ enum {
 #define PCIE_ATU_UNR_LOWER_TARGET	0x14
 #define PCIE_ATU_UNR_UPPER_TARGET	0x18
 
+#define PCIE_ATU_REGION_INDEX2		(0x2 << 0)
 #define PCIE_ATU_REGION_INDEX1		(0x1 << 0)
 #define PCIE_ATU_REGION_INDEX0		(0x0 << 0)
 #define PCIE_ATU_TYPE_MEM		(0x0 << 0)
@@ -369,15 +373,22 @@ static uintptr_t set_cfg_address(struct rk_pcie *pcie,
 
 	/*
 	 * Not accessing root port configuration space?
-	 * Region #0 is used for Outbound CFG space access.
+	 * Region #1 is used for Outbound CFG space access.
 	 * Direction = Outbound
-	 * Region Index = 0
+	 * Region Index = 1
+	 *
+	 * Enumeration issues many accesses to the same function in a row,
+	 * so only reprogram the region when the target changes.
 	 */
 	d = PCI_MASK_BUS(d);
 	d = PCI_ADD_BUS(bus, d);
-	rk_pcie_prog_outbound_atu_unroll(pcie, PCIE_ATU_REGION_INDEX1,
-					 atu_type, (u64)pcie->cfg_base,
-					 d << 8, pcie->cfg_size);
+	if (pcie->cfg_atu_type != atu_type || pcie->cfg_atu_bdf != d) {
+		rk_pcie_prog_outbound_atu_unroll(pcie, PCIE_ATU_REGION_INDEX1,
+						 atu_type, (u64)pcie->cfg_base,
+						 d << 8, pcie->cfg_size);
+		pcie->cfg_atu_type = atu_type;
+		pcie->cfg_atu_bdf = d;
+	}
 
 	va_address = (uintptr_t)pcie->cfg_base;
 
@@ -387,6 +398,22 @@ out:
 	return va_address;
 }
 
+/*
+ * With only two outbound regions, region 1 is shared between config and
+ * I/O space and has to be pointed back at I/O space after each config
+ * access. Otherwise I/O space has a region of its own.
+ */
+static void rk_pcie_cfg_done(struct rk_pcie *pcie)
+{
+	if (pcie->num_ob_windows > 2 || !pcie->cfg_atu_type)
+		return;
+
+	rk_pcie_prog_outbound_atu_unroll(pcie, PCIE_ATU_REGION_INDEX1,
+					 PCIE_ATU_TYPE_IO, pcie->io.phys_start,
+					 pcie->io.bus_start, pcie->io.size);
+	pcie->cfg_atu_type = 0;
+}
+
 static int rockchip_pcie_rd_conf(struct udevice *bus, pci_dev_t bdf,
 				 uint offset, ulong *valuep,
 				 enum pci_size_t size)
@@ -411,9 +438,7 @@ static int rockchip_pcie_rd_conf(struct udevice *bus, pci_dev_t bdf,
 	debug("(addr,val)=(0x%04x, 0x%08lx)\n", offset, value);
 	*valuep = pci_conv_32_to_size(value, offset, size);
 
-	rk_pcie_prog_outbound_atu_unroll(pcie, PCIE_ATU_REGION_INDEX1,
-					 PCIE_ATU_TYPE_IO, pcie->io.phys_start,
-					 pcie->io.bus_start, pcie->io.size);
+	rk_pcie_cfg_done(pcie);
 
 	return 0;
 }
@@ -441,9 +466,7 @@ static int rockchip_pcie_wr_conf(struct udevice *bus, pci_dev_t bdf,
 	value = pci_conv_size_to_32(old, value, offset, size);
 	writel(value, va_address);
 
-	rk_pcie_prog_outbound_atu_unroll(pcie, PCIE_ATU_REGION_INDEX1,
-					 PCIE_ATU_TYPE_IO, pcie->io.phys_start,
-					 pcie->io.bus_start, pcie->io.size);
+	rk_pcie_cfg_done(pcie);
 
 	return 0;
 }
@@ -695,6 +718,8 @@ static int rockchip_pcie_parse_dt(struct udevice *dev)
 	else
 		priv->gen = max_link_speed;
 
+	priv->num_ob_windows = dev_read_u32_default(dev, "num-ob-windows", 2);
+
 	return 0;
 }
 
@@ -762,6 +787,13 @@ static int rockchip_pcie_probe(struct udevice *dev)
 					 PCIE_ATU_TYPE_MEM,
 					 priv->mem.phys_start,
 					 priv->mem.bus_start, priv->mem.size);
+
+	if (priv->num_ob_windows > 2)
+		rk_pcie_prog_outbound_atu_unroll(priv, PCIE_ATU_REGION_INDEX2,
+						 PCIE_ATU_TYPE_IO,
+						 priv->io.phys_start,
+						 priv->io.bus_start,
+						 priv->io.size);
 	return 0;
 }
 
@@ -2067,7 +2067,14 @@ static void save_rw_trn_deskew(void __iomem *phy_base,
 
 static void save_rw_trn_result_to_ddr(struct rw_trn_result *result)
 {
-	result->flag = DDR_DQ_EYE_FLAG;
+	int i;
+
+	/* no fsp trained, e.g. all restored from the training cache */
+	result->flag = 0;
+	for (i = 0; i < FSP_NUM; i++) {
+		if (result->fsp_mhz[i])
+			result->flag = DDR_DQ_EYE_FLAG;
+	}
 	memcpy((void *)(RW_TRN_RESULT_ADDR), result, sizeof(*result));
 }
 #endif
@@ -2185,6 +2192,204 @@ out:
 	return ret;
 }
 
+#if defined(CONFIG_ROCKCHIP_DRAM_TRAINING_CACHE)
+static struct rv1126_trn_cache *trn_cache =
+	(struct rv1126_trn_cache *)CONFIG_ROCKCHIP_DRAM_TRAINING_CACHE_ADDR;
+/* fsp which may be restored from trn_cache, one bit per fsp */
+static u32 trn_cache_valid;
+static u32 trn_cache_dirty;
+static u32 trn_cache_cs1_base;
+/* sum of the loader's dram parameters, taken before any is adjusted */
+static u32 trn_cache_params;
+
+static u16 wrlvl_adr[4] = {0x233, 0x237, 0x2b3, 0x2b7};
+
+static u32 trn_cache_sum(u32 sum, const void *buf, u32 size)
+{
+	const u32 *p = buf;
+	u32 i;
+
+	for (i = 0; i < size / 4; i++)
+		sum = ((sum << 5) | (sum >> 27)) ^ p[i];
+
+	return sum;
+}
+
+static u32 trn_cache_checksum(struct rv1126_trn_cache *cache)
+{
+	return trn_cache_sum(0, cache,
+			     offsetof(struct rv1126_trn_cache, checksum));
+}
+
+/*
+ * Training results are only valid for the drive strength, odt and
+ * timings they were taken with, so a loader carrying other parameters
+ * must not restore them.
+ */
+static void trn_cache_params_init(void)
+{
+	trn_cache_params = trn_cache_sum(0, sdram_configs,
+					 sizeof(sdram_configs));
+	trn_cache_params = trn_cache_sum(trn_cache_params, common_info,
+					 sizeof(common_info));
+}
+
+static void trn_cache_check(struct rv1126_sdram_params *sdram_params)
+{
+	struct sdram_cap_info *cap_info = &sdram_params->ch.cap_info;
+	u32 dramtype = sdram_params->base.dramtype;
+	u32 i;
+
+	trn_cache_valid = 0;
+	trn_cache_dirty = 0;
+	trn_cache_cs1_base = CONFIG_SYS_SDRAM_BASE +
+			     (u32)sdram_get_cs_cap(cap_info, 0, dramtype);
+
+	/* vref training of LPDDR4/LPDDR4X is not cached */
+	if (dramtype == LPDDR4 || dramtype == LPDDR4X)
+		return;
+
+	if (trn_cache->flag != TRN_CACHE_FLAG ||
+	    trn_cache->size != sizeof(*trn_cache) ||
+	    trn_cache->dramtype != dramtype ||
+	    trn_cache->params != trn_cache_params ||
+	    memcmp(&trn_cache->cap_info, cap_info, sizeof(*cap_info)) ||
+	    trn_cache->checksum != trn_cache_checksum(trn_cache)) {
+		trn_cache->flag = 0;
+		for (i = 0; i < MAX_IDX; i++)
+			trn_cache->fsp[i].freq_mhz = 0;
+		return;
+	}
+
+	for (i = 0; i < MAX_IDX; i++) {
+		if (trn_cache->fsp[i].freq_mhz)
+			trn_cache_valid |= BIT(i);
+	}
+}
+
+static int trn_cache_pattern_test(u32 base)
+{
+	u32 i, pattern;
+
+	for (i = 0; i < 16; i++) {
+		pattern = (i & 1) ? ~BIT(i) : (0x5aa5a55a ^ BIT(i + 16));
+		writel(pattern, base + i * 4);
+	}
+	for (i = 0; i < 16; i++) {
+		pattern = (i & 1) ? ~BIT(i) : (0x5aa5a55a ^ BIT(i + 16));
+		if (readl(base + i * 4) != pattern)
+			return -1;
+	}
+
+	return 0;
+}
+
+/* return: 1 = restored and verified, 0 = need training */
+static int trn_cache_restore(struct dram_info *dram,
+			     struct rv1126_sdram_params *sdram_params,
+			     u32 fsp)
+{
+	struct rv1126_trn_cache_fsp *cache = &trn_cache->fsp[fsp];
+	void __iomem *phy_base = dram->phy;
+	u32 rank = sdram_params->ch.cap_info.rank;
+	u32 group, i;
+	int ret;
+
+	if (!(trn_cache_valid & BIT(fsp)) ||
+	    cache->freq_mhz != sdram_params->base.ddr_freq)
+		return 0;
+
+	enter_sr(dram, 1);
+	for (i = 0; i < TRN_CACHE_CA_NUM; i++)
+		writel(cache->ca_deskew[i], PHY_REG(phy_base, 0x150 + i));
+	enter_sr(dram, 0);
+
+	for (group = 0; group < 4; group++)
+		for (i = 0; i < TRN_CACHE_GRP_NUM; i++)
+			writel(cache->dq_deskew[group][i],
+			       PHY_REG(phy_base, grp_addr[group] + i));
+	update_dq_rx_prebit(dram);
+	update_dq_tx_prebit(dram);
+
+	for (i = 0; i < ARRAY_SIZE(wrlvl_adr); i++)
+		writel(cache->wrlvl[i], PHY_REG(phy_base, wrlvl_adr[i]));
+
+	ret = data_training(dram, 0, sdram_params, 0, READ_GATE_TRAINING);
+	ret |= trn_cache_pattern_test(CONFIG_SYS_SDRAM_BASE);
+	if (rank == 2) {
+		ret |= data_training(dram, 1, sdram_params, 0,
+				     READ_GATE_TRAINING);
+		ret |= trn_cache_pattern_test(trn_cache_cs1_base);
+	}
+	if (ret) {
+		printascii("training cache mismatch, retrain\n");
+		trn_cache_valid = 0;
+		return 0;
+	}
+
+	return 1;
+}
+
+static void trn_cache_save(struct dram_info *dram, u32 fsp, u32 freq)
+{
+	struct rv1126_trn_cache_fsp *cache = &trn_cache->fsp[fsp];
+	void __iomem *phy_base = dram->phy;
+	u32 group, i;
+
+	cache->freq_mhz = freq;
+	for (i = 0; i < TRN_CACHE_CA_NUM; i++)
+		cache->ca_deskew[i] = readb(PHY_REG(phy_base, 0x150 + i));
+	for (group = 0; group < 4; group++)
+		for (i = 0; i < TRN_CACHE_GRP_NUM; i++)
+			cache->dq_deskew[group][i] =
+				readb(PHY_REG(phy_base, grp_addr[group] + i));
+	for (i = 0; i < ARRAY_SIZE(wrlvl_adr); i++)
+		cache->wrlvl[i] = readb(PHY_REG(phy_base, wrlvl_adr[i]));
+
+	trn_cache_dirty |= BIT(fsp);
+}
+
+static void trn_cache_commit(struct rv1126_sdram_params *sdram_params)
+{
+	u32 dramtype = sdram_params->base.dramtype;
+
+	if (!trn_cache_dirty ||
+	    dramtype == LPDDR4 || dramtype == LPDDR4X)
+		return;
+
+	trn_cache->flag = TRN_CACHE_FLAG;
+	trn_cache->size = sizeof(*trn_cache);
+	trn_cache->dramtype = dramtype;
+	trn_cache->params = trn_cache_params;
+	memcpy(&trn_cache->cap_info, &sdram_params->ch.cap_info,
+	       sizeof(trn_cache->cap_info));
+	trn_cache->checksum = trn_cache_checksum(trn_cache);
+}
+#else
+static inline void trn_cache_params_init(void)
+{
+}
+
+static inline void trn_cache_check(struct rv1126_sdram_params *sdram_params)
+{
+}
+
+static inline int trn_cache_restore(struct dram_info *dram,
+				    struct rv1126_sdram_params *sdram_params,
+				    u32 fsp)
+{
+	return 0;
+}
+
+static inline void trn_cache_save(struct dram_info *dram, u32 fsp, u32 freq)
+{
+}
+
+static inline void trn_cache_commit(struct rv1126_sdram_params *sdram_params)
+{
+}
+#endif
+
 static void set_ddrconfig(struct dram_info *dram, u32 ddrconfig)
 {
 	writel(ddrconfig, &dram->msch->deviceconf);
@@ -3434,7 +3639,9 @@ void ddr_set_rate(struct dram_info *dram,
 	update_refresh_reg(dram);
 
 	/* training */
-	high_freq_training(dram, sdram_params_new, dst_fsp);
+	if (!trn_cache_restore(dram, sdram_params_new, dst_fsp) &&
+	    !high_freq_training(dram, sdram_params_new, dst_fsp))
+		trn_cache_save(dram, dst_fsp, freq);
 	low_power_update(dram, lp_stat);
 
 	save_fsp_param(dram, dst_fsp, sdram_params_new);
@@ -3472,6 +3679,8 @@ static void ddr_set_rate_for_fsp(struct dram_info *dram,
 	if (get_wrlvl_val(dram, sdram_params))
 		printascii("get wrlvl value fail\n");
 
+	trn_cache_check(sdram_params);
+
 #ifndef CONFIG_SPL_KERNEL_BOOT
 	printascii("change to: ");
 	printdec(f1);
@@ -3495,6 +3704,8 @@ static void ddr_set_rate_for_fsp(struct dram_info *dram,
 #else
 	ddr_set_rate(&dram_info, sdram_params, f0, sdram_params->base.ddr_freq, 1, 1, 1);
 #endif
+
+	trn_cache_commit(sdram_params);
 }
 
 int get_uart_config(void)
@@ -3555,6 +3766,7 @@ int sdram_init(void)
 	dram_info.sr_idle = SR_INFO(gbl_info->sr_pd_info);
 	dram_info.pd_idle = PD_INFO(gbl_info->sr_pd_info);
 
+	trn_cache_params_init();
 	sdram_params = &sdram_configs[0];
 	#if (CONFIG_ROCKCHIP_TPL_INIT_DRAM_TYPE == 8)
 	for (j = 0; j < ARRAY_SIZE(sdram_configs); j++)
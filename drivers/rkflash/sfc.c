@@ -78,12 +78,10 @@ void sfc_clean_irq(void)
 	writel(0xFFFFFFFF, g_sfc_reg + SFC_IMR);
 }
 
-int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size)
+static int sfc_xfer_setup(struct rk_sfc_op *op, u32 addr, u32 size)
 {
-	int ret = SFC_OK;
 	union SFCCMD_DATA cmd;
 	int reg;
-	int timeout = 0;
 
 	reg = readl(g_sfc_reg + SFC_FSR);
 
@@ -120,6 +118,85 @@ int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size)
 	if (cmd.b.addrbits)
 		writel(addr, g_sfc_reg + SFC_ADDR);
 
+	return SFC_OK;
+}
+
+static void sfc_dma_kick(void *dma_buf)
+{
+	writel(0xFFFFFFFF, g_sfc_reg + SFC_ICLR);
+	writel(~((u32)DMA_INT), g_sfc_reg + SFC_IMR);
+	writel((unsigned long)dma_buf, g_sfc_reg + SFC_DMA_ADDR);
+	writel(SFC_DMA_START, g_sfc_reg + SFC_DMA_TRIGGER);
+}
+
+static int sfc_dma_poll(u32 size)
+{
+	int timeout = size * 10;
+
+	while ((readl(g_sfc_reg + SFC_SR) & SFC_BUSY) && (timeout-- > 0))
+		sfc_delay(1);
+
+	writel(0xFFFFFFFF, g_sfc_reg + SFC_ICLR);
+
+	return timeout <= 0 ? SFC_WAIT_TIMEOUT : SFC_OK;
+}
+
+static int sfc_wait_idle(int ret)
+{
+	int timeout = 0;    /* wait cmd or data send complete */
+
+	while (readl(g_sfc_reg + SFC_SR) & SFC_BUSY) {
+		sfc_delay(1);
+
+		if (timeout++ > 100000) {         /* wait 100ms */
+			ret = SFC_TX_TIMEOUT;
+			break;
+		}
+	}
+
+	sfc_delay(1); /* CS# High Time (read/write) >100ns */
+	return ret;
+}
+
+/*
+ * Start a DMA transfer without waiting for it to finish. @dma_buf must be
+ * ARCH_DMA_MINALIGN aligned and its cache lines must already be cleaned by
+ * the caller. The transfer has to be completed by sfc_request_wait() before
+ * the next request is issued.
+ */
+int sfc_request_async(struct rk_sfc_op *op, u32 addr, void *dma_buf, u32 size)
+{
+	int ret;
+
+	if (!size || (unsigned long)dma_buf & (ARCH_DMA_MINALIGN - 1))
+		return SFC_PARAM_ERR;
+
+	op->sfctrl.b.enbledma = 1;
+	ret = sfc_xfer_setup(op, addr, size);
+	if (ret != SFC_OK)
+		return ret;
+
+	sfc_dma_kick(dma_buf);
+
+	return SFC_OK;
+}
+
+int sfc_request_wait(u32 size)
+{
+	return sfc_wait_idle(sfc_dma_poll(size));
+}
+
+int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size)
+{
+	int ret = SFC_OK;
+	union SFCCMD_DATA cmd;
+	int timeout = 0;
+
+	cmd.d32 = op->sfcmd.d32;
+	ret = sfc_xfer_setup(op, addr, size);
+	if (ret != SFC_OK)
+		return ret;
+
 	if (!size)
 		goto exit_wait;
 
@@ -136,21 +213,8 @@ int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size)
 		if (ret)
 			return ret;
 
-		writel(0xFFFFFFFF, g_sfc_reg + SFC_ICLR);
-		writel(~((u32)DMA_INT), g_sfc_reg + SFC_IMR);
-		writel((unsigned long)bb.bounce_buffer, g_sfc_reg + SFC_DMA_ADDR);
-		writel(SFC_DMA_START, g_sfc_reg + SFC_DMA_TRIGGER);
-
-		timeout = size * 10;
-
-		while ((readl(g_sfc_reg + SFC_SR) & SFC_BUSY) &&
-		       (timeout-- > 0))
-			sfc_delay(1);
-
-		writel(0xFFFFFFFF, g_sfc_reg + SFC_ICLR);
-
-		if (timeout <= 0)
-			ret = SFC_WAIT_TIMEOUT;
+		sfc_dma_kick(bb.bounce_buffer);
+		ret = sfc_dma_poll(size);
 		bounce_buffer_stop(&bb);
 	} else {
 		u32 i, words, count, bytes;
@@ -248,17 +312,5 @@ int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size)
 	}
 
 exit_wait:
-	timeout = 0;    /* wait cmd or data send complete */
-
-	while (readl(g_sfc_reg + SFC_SR) & SFC_BUSY) {
-		sfc_delay(1);
-
-		if (timeout++ > 100000) {         /* wait 100ms */
-			ret = SFC_TX_TIMEOUT;
-			break;
-		}
-	}
-
-	sfc_delay(1); /* CS# High Time (read/write) >100ns */
-	return ret;
+	return sfc_wait_idle(ret);
 }
@@ -213,6 +213,8 @@ struct id_block_tag {
 
 int sfc_init(void __iomem *reg_addr);
 int sfc_request(struct rk_sfc_op *op, u32 addr, void *data, u32 size);
+int sfc_request_async(struct rk_sfc_op *op, u32 addr, void *dma_buf, u32 size);
+int sfc_request_wait(u32 size);
 u16 sfc_get_version(void);
 void sfc_clean_irq(void);
 u32 sfc_get_max_iosize(void);
@@ -187,7 +187,8 @@ static struct nand_info spi_nand_tbl[] = {
 };
 
 static struct nand_info *p_nand_info;
-static u32 gp_page_buf[SFC_NAND_PAGE_MAX_SIZE / 4];
+/* DMA target of whole page reads, aligned so sfc_request() needs no bounce */
+static u32 gp_page_buf[SFC_NAND_PAGE_MAX_SIZE / 4] __aligned(ARCH_DMA_MINALIGN);
 static struct SFNAND_DEV sfc_nand_dev;
 
 static struct nand_info *sfc_nand_get_info(u8 *nand_id)
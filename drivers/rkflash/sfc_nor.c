@@ -3,6 +3,8 @@
  *
  * SPDX-License-Identifier:	GPL-2.0
  */
+#include <common.h>
+#include <malloc.h>
 #include <linux/compat.h>
 #include <linux/delay.h>
 #include <linux/kernel.h>
@@ -479,38 +481,45 @@ int snor_disable_QE(struct SFNOR_DEV *p_dev)
 	return p_dev->write_status(reg_index, status);
 }
 
-int snor_read_data(struct SFNOR_DEV *p_dev,
-		   u32 addr,
-		   void *p_data,
-		   u32 size)
+static void snor_read_op_init(struct SFNOR_DEV *p_dev,
+			      struct rk_sfc_op *op,
+			      u32 *addr)
 {
-	int ret;
-	struct rk_sfc_op op;
-
-	op.sfcmd.d32 = 0;
-	op.sfcmd.b.cmd = p_dev->read_cmd;
-	op.sfcmd.b.addrbits = SFC_ADDR_24BITS;
+	op->sfcmd.d32 = 0;
+	op->sfcmd.b.cmd = p_dev->read_cmd;
+	op->sfcmd.b.addrbits = SFC_ADDR_24BITS;
 
-	op.sfctrl.d32 = 0;
-	op.sfctrl.b.datalines = p_dev->read_lines;
-	if (!(size & 0x3) && size >= 4)
-		op.sfctrl.b.enbledma = 1;
+	op->sfctrl.d32 = 0;
+	op->sfctrl.b.datalines = p_dev->read_lines;
 
 	if (p_dev->read_cmd == CMD_FAST_READ_X1 ||
 	    p_dev->read_cmd == CMD_PAGE_FASTREAD4B ||
 	    p_dev->read_cmd == CMD_FAST_READ_X4 ||
 	    p_dev->read_cmd == CMD_FAST_READ_X2 ||
 	    p_dev->read_cmd == CMD_FAST_4READ_X4) {
-		op.sfcmd.b.dummybits = 8;
+		op->sfcmd.b.dummybits = 8;
 	} else if (p_dev->read_cmd == CMD_FAST_READ_A4) {
-		op.sfcmd.b.addrbits = SFC_ADDR_32BITS;
-		addr = (addr << 8) | 0xFF;	/* Set M[7:0] = 0xFF */
-		op.sfcmd.b.dummybits = 4;
-		op.sfctrl.b.addrlines = SFC_4BITS_LINE;
+		op->sfcmd.b.addrbits = SFC_ADDR_32BITS;
+		*addr = (*addr << 8) | 0xFF;	/* Set M[7:0] = 0xFF */
+		op->sfcmd.b.dummybits = 4;
+		op->sfctrl.b.addrlines = SFC_4BITS_LINE;
 	}
 
 	if (p_dev->addr_mode == ADDR_MODE_4BYTE)
-		op.sfcmd.b.addrbits = SFC_ADDR_32BITS;
+		op->sfcmd.b.addrbits = SFC_ADDR_32BITS;
+}
+
+int snor_read_data(struct SFNOR_DEV *p_dev,
+		   u32 addr,
+		   void *p_data,
+		   u32 size)
+{
+	int ret;
+	struct rk_sfc_op op;
+
+	snor_read_op_init(p_dev, &op, &addr);
+	if (!(size & 0x3) && size >= 4)
+		op.sfctrl.b.enbledma = 1;
 
 	ret = sfc_request(&op, addr, p_data, size);
 	rkflash_print_dio("%s %x %x\n", __func__, addr, *(u32 *)(p_data));
@@ -518,39 +527,168 @@ int snor_read_data(struct SFNOR_DEV *p_dev,
 	return ret;
 }
 
-int snor_read(struct SFNOR_DEV *p_dev, u32 sec, u32 n_sec, void *p_data)
+static int snor_read_start(struct SFNOR_DEV *p_dev,
+			   u32 addr,
+			   void *dma_buf,
+			   u32 size)
 {
+	struct rk_sfc_op op;
+
+	snor_read_op_init(p_dev, &op, &addr);
+
+	return sfc_request_async(&op, addr, dma_buf, size);
+}
+
+/*
+ * Aligned destination: DMA straight into the caller's buffer, no bounce
+ * buffer and no copy.
+ */
+static int snor_read_direct(struct SFNOR_DEV *p_dev, u32 addr, u8 *p_buf,
+			    u32 size)
+{
+	ulong start = (ulong)p_buf;
 	int ret = SFC_OK;
-	u32 addr, size, len;
-	u8 *p_buf =  (u8 *)p_data;
+	u32 len;
 
-	rkflash_print_dio("%s %x %x\n", __func__, sec, n_sec);
+	invalidate_dcache_range(start, start + size);
 
-	if ((sec + n_sec) > p_dev->capacity)
-		return SFC_PARAM_ERR;
+	while (size) {
+		len = size < p_dev->max_iosize ? size : p_dev->max_iosize;
+		ret = snor_read_start(p_dev, addr, p_buf, len);
+		if (ret == SFC_OK)
+			ret = sfc_request_wait(len);
+		if (ret != SFC_OK)
+			break;
+
+		size -= len;
+		addr += len;
+		p_buf += len;
+	}
+
+	invalidate_dcache_range(start, (ulong)p_buf);
+
+	return ret;
+}
+
+static int snor_pp_buf_init(struct SFNOR_DEV *p_dev)
+{
+	int i;
+
+	/*
+	 * Only tried once, a failed attempt is not retried since simple
+	 * malloc never gives the memory back.
+	 */
+	if (p_dev->pp_len)
+		return p_dev->pp_buf[1] ? SFC_OK : SFC_ERROR;
+
+	p_dev->pp_len = min_t(u32, p_dev->max_iosize, SNOR_DMA_PP_SIZE);
+	for (i = 0; i < 2; i++) {
+		p_dev->pp_buf[i] = memalign(ARCH_DMA_MINALIGN, p_dev->pp_len);
+		if (!p_dev->pp_buf[i])
+			goto err;
+		invalidate_dcache_range((ulong)p_dev->pp_buf[i],
+					(ulong)p_dev->pp_buf[i] + p_dev->pp_len);
+	}
+
+	return SFC_OK;
+err:
+	free(p_dev->pp_buf[0]);
+	p_dev->pp_buf[0] = NULL;
+
+	return SFC_ERROR;
+}
+
+/*
+ * Unaligned destination: ping-pong between two DMA buffers so that the
+ * copy out of one buffer overlaps with the transfer into the other.
+ */
+static int snor_read_pingpong(struct SFNOR_DEV *p_dev, u32 addr, u8 *p_buf,
+			      u32 size)
+{
+	u32 len, next_len;
+	u8 *cur, *next;
+	int ret;
+
+	cur = p_dev->pp_buf[0];
+	next = p_dev->pp_buf[1];
+	len = size < p_dev->pp_len ? size : p_dev->pp_len;
+	ret = snor_read_start(p_dev, addr, cur, len);
+
+	while (ret == SFC_OK) {
+		ret = sfc_request_wait(len);
+		if (ret != SFC_OK)
+			break;
+
+		invalidate_dcache_range((ulong)cur, (ulong)cur + p_dev->pp_len);
+		size -= len;
+		addr += len;
+
+		next_len = size < p_dev->pp_len ? size : p_dev->pp_len;
+		if (next_len)
+			ret = snor_read_start(p_dev, addr, next, next_len);
+
+		memcpy(p_buf, cur, len);
+		p_buf += len;
+
+		if (!next_len)
+			break;
+
+		swap(cur, next);
+		len = next_len;
+	}
+
+	return ret;
+}
+
+static int snor_read_chunked(struct SFNOR_DEV *p_dev, u32 addr, u8 *p_buf,
+			     u32 size)
+{
+	int ret = SFC_OK;
+	u32 len;
 
-	addr = sec << 9;
-	size = n_sec << 9;
 	while (size) {
 		len = size < p_dev->max_iosize ? size : p_dev->max_iosize;
 		ret = snor_read_data(p_dev, addr, p_buf, len);
-		if (ret != SFC_OK) {
-			rkflash_print_error("snor_read_data %x ret= %x\n",
-					    addr >> 9, ret);
-			goto out;
-		}
+		if (ret != SFC_OK)
+			break;
 
 		size -= len;
 		addr += len;
 		p_buf += len;
 	}
-out:
-	if (!ret)
-		ret = n_sec;
 
 	return ret;
 }
 
+int snor_read(struct SFNOR_DEV *p_dev, u32 sec, u32 n_sec, void *p_data)
+{
+	int ret = SFC_OK;
+	u32 addr, size;
+	u8 *p_buf =  (u8 *)p_data;
+
+	rkflash_print_dio("%s %x %x\n", __func__, sec, n_sec);
+
+	if ((sec + n_sec) > p_dev->capacity)
+		return SFC_PARAM_ERR;
+
+	addr = sec << 9;
+	size = n_sec << 9;
+	if (!((ulong)p_buf & (ARCH_DMA_MINALIGN - 1)) &&
+	    !(size & (ARCH_DMA_MINALIGN - 1)))
+		ret = snor_read_direct(p_dev, addr, p_buf, size);
+	else if (snor_pp_buf_init(p_dev) == SFC_OK)
+		ret = snor_read_pingpong(p_dev, addr, p_buf, size);
+	else
+		ret = snor_read_chunked(p_dev, addr, p_buf, size);
+
+	if (ret != SFC_OK) {
+		rkflash_print_error("snor_read %x ret= %x\n", sec, ret);
+		return ret;
+	}
+
+	return n_sec;
+}
+
 int snor_write(struct SFNOR_DEV *p_dev, u32 sec, u32 n_sec, void *p_data)
 {
 	int ret = SFC_OK;
@@ -729,6 +867,8 @@ int snor_init(struct SFNOR_DEV *p_dev)
 	if (!p_dev)
 		return SFC_PARAM_ERR;
 
+	free(p_dev->pp_buf[0]);
+	free(p_dev->pp_buf[1]);
 	memset((void *)p_dev, 0, sizeof(struct SFNOR_DEV));
 	p_dev->max_iosize = sfc_get_max_iosize();
 
@@ -14,6 +14,9 @@
 #define NOR_SECS_BLK		(NOR_BLOCK_SIZE / 512)
 #define NOR_SECS_PAGE		8
 
+/* size of each DMA ping-pong buffer used for unaligned reads */
+#define SNOR_DMA_PP_SIZE	(32 * 1024)
+
 #define FEA_READ_STATUE_MASK	(0x3 << 0)
 #define FEA_STATUE_MODE1	0
 #define FEA_STATUE_MODE2	1
@@ -117,6 +120,10 @@ struct SFNOR_DEV {
 
 	SNOR_WRITE_STATUS write_status;
 	u32 max_iosize;
+
+	/* DMA ping-pong buffers for unaligned reads */
+	u8 *pp_buf[2];
+	u32 pp_len;
 };
 
 struct flash_info {
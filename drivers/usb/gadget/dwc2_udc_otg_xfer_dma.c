@@ -93,12 +93,23 @@ static inline void dwc2_ep0_complete_out(void)
 static int setdma_rx(struct dwc2_ep *ep, struct dwc2_request *req)
 {
 	u32 *buf, ctrl;
-	u32 length, pktcnt;
+	u32 length, pktcnt, max_len;
 	u32 ep_num = ep_index(ep);
 
+	/*
+	 * A chunk of a larger request must end on a packet boundary, or
+	 * complete_rx() takes its end for a short packet.
+	 */
+	if (ep_num) {
+		max_len = min_t(u32, DOEPT_SIZ_XFER_SIZE_MAX_EP,
+				DOEPT_SIZ_PKT_CNT_MAX_EP * ep->ep.maxpacket);
+		max_len -= max_len % ep->ep.maxpacket;
+	} else {
+		max_len = ep->ep.maxpacket;
+	}
+
 	buf = req->req.buf + req->req.actual;
-	length = min_t(u32, req->req.length - req->req.actual,
-		       ep_num ? DOEPT_SIZ_XFER_SIZE_MAX_EP : ep->ep.maxpacket);
+	length = min_t(u32, req->req.length - req->req.actual, max_len);
 
 	ep->len = length;
 	ep->dma_buf = buf;
@@ -58,6 +58,12 @@
 #define TX_ENDPOINT_MAXIMUM_PACKET_SIZE      (0x0040)
 
 #define EP_BUFFER_SIZE			4096
+/*
+ * Largest OUT request received straight into the download buffer. A UDC
+ * with a smaller per-transfer limit must split it on packet boundaries, as
+ * DWC2's setdma_rx() does, or the first part completes as a short packet.
+ */
+#define DL_CHUNK_SIZE			(1024 * 1024)
 #define SLEEP_COUNT 20000
 #define MAX_PART_NUM_STR_SIZE 4
 #define PARTITION_TYPE_STRINGS "partition-type"
@@ -74,6 +80,8 @@ struct f_fastboot {
 	/* IN/OUT EP's and corresponding requests */
 	struct usb_ep *in_ep, *out_ep;
 	struct usb_request *in_req, *out_req;
+	/* out_req's own buffer, out_req->buf points elsewhere on download */
+	void *out_req_buf;
 };
 
 static inline struct f_fastboot *func_to_fastboot(struct usb_function *f)
@@ -395,7 +403,7 @@ static void fastboot_disable(struct usb_function *f)
 	usb_ep_disable(f_fb->in_ep);
 
 	if (f_fb->out_req) {
-		free(f_fb->out_req->buf);
+		free(f_fb->out_req_buf);
 		usb_ep_free_request(f_fb->out_ep, f_fb->out_req);
 		f_fb->out_req = NULL;
 	}
@@ -452,6 +460,7 @@ static int fastboot_set_alt(struct usb_function *f,
 		goto err;
 	}
 	f_fb->out_req->complete = rx_handler_command;
+	f_fb->out_req_buf = f_fb->out_req->buf;
 
 	d = fb_ep_desc(gadget, &fs_ep_in, &hs_ep_in, &ss_ep_in,
 		       &ss_ep_in_comp_desc, f_fb->in_ep);
@@ -1563,6 +1572,28 @@ static unsigned int rx_bytes_expected(struct usb_ep *ep)
 	return rx_remain;
 }
 
+/*
+ * Set up the OUT request for the next part of a download. Whole max-packet
+ * multiples are received by DMA straight into the download buffer, which
+ * saves a memcpy and lets the controller move up to DL_CHUNK_SIZE per
+ * request. A short tail, or a cache-unaligned position after a short
+ * packet, goes through the endpoint buffer as before.
+ */
+static void rx_prepare_dl(struct usb_ep *ep, struct usb_request *req)
+{
+	ulong dst = CONFIG_FASTBOOT_BUF_ADDR + download_bytes;
+	unsigned int rx_remain = download_size - download_bytes;
+	unsigned int len = rx_remain - rx_remain % ep->maxpacket;
+
+	if (len && IS_ALIGNED(dst, ARCH_DMA_MINALIGN)) {
+		req->buf = (void *)dst;
+		req->length = min_t(unsigned int, len, DL_CHUNK_SIZE);
+	} else {
+		req->buf = fastboot_func->out_req_buf;
+		req->length = rx_bytes_expected(ep);
+	}
+}
+
 #define BYTES_PER_DOT	0x20000
 static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 {
@@ -1580,16 +1611,18 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 	if (buffer_size < transfer_size)
 		transfer_size = buffer_size;
 
-	memcpy((void *)CONFIG_FASTBOOT_BUF_ADDR + download_bytes,
-	       buffer, transfer_size);
+	/* Data received by DMA into the download buffer needs no copy */
+	if (buffer == fastboot_func->out_req_buf)
+		memcpy((void *)CONFIG_FASTBOOT_BUF_ADDR + download_bytes,
+		       buffer, transfer_size);
 
 	pre_dot_num = download_bytes / BYTES_PER_DOT;
 	download_bytes += transfer_size;
 	now_dot_num = download_bytes / BYTES_PER_DOT;
 
-	if (pre_dot_num != now_dot_num) {
+	while (pre_dot_num < now_dot_num) {
 		putc('.');
-		if (!(now_dot_num % 74))
+		if (!(++pre_dot_num % 74))
 			putc('\n');
 	}
 
@@ -1601,6 +1634,7 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 		 */
 		download_size = 0;
 		req->complete = rx_handler_command;
+		req->buf = fastboot_func->out_req_buf;
 		req->length = EP_BUFFER_SIZE;
 
 		strcpy(response, "OKAY");
@@ -1608,7 +1642,7 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 
 		printf("\ndownloading of %d bytes finished\n", download_bytes);
 	} else {
-		req->length = rx_bytes_expected(ep);
+		rx_prepare_dl(ep, req);
 	}
 
 	req->actual = 0;
@@ -1634,7 +1668,7 @@ static void cb_download(struct usb_ep *ep, struct usb_request *req)
 	} else {
 		sprintf(response, "DATA%08x", download_size);
 		req->complete = rx_handler_dl_image;
-		req->length = rx_bytes_expected(ep);
+		rx_prepare_dl(ep, req);
 	}
 
 	fastboot_tx_write_str(response);
@@ -245,6 +245,7 @@
 #include <malloc.h>
 #include <common.h>
 #include <console.h>
+#include <div64.h>
 #include <g_dnl.h>
 
 #include <linux/err.h>
@@ -320,6 +321,11 @@ struct fsg_common {
 	u32			residue;
 	u32			usb_amount_left;
 
+	/* Write throughput of the current run of WRITE commands */
+	u64			wr_bytes;
+	ulong			wr_start;
+	ulong			wr_end;
+
 	unsigned int		can_stall:1;
 	unsigned int		free_storage_on_release:1;
 	unsigned int		phase_error:1;
@@ -848,6 +854,9 @@ static int do_write(struct fsg_common *common)
 		return -EINVAL;
 	}
 
+	if (!common->wr_bytes)
+		common->wr_start = get_timer(0);
+
 	/* Carry out the file writes */
 	get_some_more = 1;
 	file_offset = usb_offset = ((loff_t) lba) << 9;
@@ -955,6 +964,8 @@ static int do_write(struct fsg_common *common)
 			file_offset += nwritten;
 			amount_left_to_write -= nwritten;
 			common->residue -= nwritten;
+			common->wr_bytes += nwritten;
+			common->wr_end = get_timer(0);
 
 			/* If an error occurred, report it and its position */
 			if (nwritten < amount) {
@@ -982,6 +993,43 @@ static int do_write(struct fsg_common *common)
 	return -EIO;		/* No default reply */
 }
 
+static int is_write_cmnd(u8 cmnd)
+{
+	switch (cmnd) {
+	case SC_WRITE_6:
+	case SC_WRITE_10:
+	case SC_WRITE_12:
+#ifdef CONFIG_CMD_ROCKUSB
+	case RKUSB_LBA_WRITE_10:
+#endif
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Print the throughput of the run of WRITE commands that just ended, on the
+ * first other command or when the session ends
+ */
+static void report_write_rate(struct fsg_common *common)
+{
+	ulong ms, kbps;
+
+	if (!common->wr_bytes)
+		return;
+
+	ms = common->wr_end - common->wr_start;
+	printf("UMS: wrote %llu KiB in %lu ms", common->wr_bytes >> 10, ms);
+	if (ms) {
+		kbps = lldiv(common->wr_bytes, ms);
+		printf(", %lu.%02lu MB/s", kbps / 1000, (kbps % 1000) / 10);
+	}
+	printf("\n");
+
+	common->wr_bytes = 0;
+}
+
 /*-------------------------------------------------------------------------*/
 
 static int do_synchronize_cache(struct fsg_common *common)
@@ -1798,6 +1846,9 @@ static int do_scsi_command(struct fsg_common *common)
 
 	down_read(&common->filesem);	/* We're using the backing file */
 
+	if (!is_write_cmnd(common->cmnd[0]))
+		report_write_rate(common);
+
 	cdev_name = common->fsg->function.config->cdev->driver->name;
 	if (IS_RKUSB_UMS_DNL(cdev_name)) {
 		rc = rkusb_cmd_process(common, bh, &reply);
@@ -2657,6 +2708,9 @@ static void fsg_unbind(struct usb_configuration *c, struct usb_function *f)
 	struct fsg_dev		*fsg = fsg_from_func(f);
 
 	DBG(fsg, "unbind\n");
+	/* The session ends, report a run of writes no command followed */
+	report_write_rate(fsg->common);
+
 	if (fsg->common->fsg == fsg) {
 		fsg->common->new_fsg = NULL;
 		raise_exception(fsg->common, FSG_STATE_CONFIG_CHANGE);
@@ -1638,8 +1638,8 @@ int ext4fs_read_inode(struct ext2_data *data, int ino, struct ext2_inode *inode)
 	return 1;
 }
 
-long int read_allocated_block(struct ext2_inode *inode, int fileblock,
-			      struct ext_block_cache *cache)
+/* Map a file block of an inode without extents, via its indirect blocks */
+static long int read_indirect_block(struct ext2_inode *inode, int fileblock)
 {
 	long int blknr;
 	int blksz;
@@ -1648,64 +1648,11 @@ long int read_allocated_block(struct ext2_inode *inode, int fileblock,
 	long int rblock;
 	long int perblock_parent;
 	long int perblock_child;
-	unsigned long long start;
 	/* get the blocksize of the filesystem */
 	blksz = EXT2_BLOCK_SIZE(ext4fs_root);
 	log2_blksz = LOG2_BLOCK_SIZE(ext4fs_root)
 		- get_fs()->dev_desc->log2blksz;
 
-	if (le32_to_cpu(inode->flags) & EXT4_EXTENTS_FL) {
-		long int startblock, endblock;
-		struct ext_block_cache *c, cd;
-		struct ext4_extent_header *ext_block;
-		struct ext4_extent *extent;
-		int i;
-
-		if (cache) {
-			c = cache;
-		} else {
-			c = &cd;
-			ext_cache_init(c);
-		}
-		ext_block =
-			ext4fs_get_extent_block(ext4fs_root, c,
-						(struct ext4_extent_header *)
-						inode->b.blocks.dir_blocks,
-						fileblock, log2_blksz);
-		if (!ext_block) {
-			printf("invalid extent block\n");
-			if (!cache)
-				ext_cache_fini(c);
-			return -EINVAL;
-		}
-
-		extent = (struct ext4_extent *)(ext_block + 1);
-
-		for (i = 0; i < le16_to_cpu(ext_block->eh_entries); i++) {
-			startblock = le32_to_cpu(extent[i].ee_block);
-			endblock = startblock + le16_to_cpu(extent[i].ee_len);
-
-			if (startblock > fileblock) {
-				/* Sparse file */
-				if (!cache)
-					ext_cache_fini(c);
-				return 0;
-
-			} else if (fileblock < endblock) {
-				start = le16_to_cpu(extent[i].ee_start_hi);
-				start = (start << 32) +
-					le32_to_cpu(extent[i].ee_start_lo);
-				if (!cache)
-					ext_cache_fini(c);
-				return (fileblock - startblock) + start;
-			}
-		}
-
-		if (!cache)
-			ext_cache_fini(c);
-		return 0;
-	}
-
 	/* Direct blocks. */
 	if (fileblock < INDIRECT_BLOCKS)
 		blknr = le32_to_cpu(inode->b.blocks.dir_blocks[fileblock]);
@@ -1991,6 +1938,94 @@ long int read_allocated_block(struct ext2_inode *inode, int fileblock,
 	return blknr;
 }
 
+/**
+ * read_allocated_run() - map a file block and the blocks following it
+ *
+ * @inode:	inode of the file
+ * @fileblock:	first file block to map
+ * @maxblocks:	upper limit for *@count, must be at least 1
+ * @count:	returns the number of file blocks, starting at @fileblock, that
+ *		are either physically contiguous or all part of the same hole
+ * @cache:	extent block cache, may be NULL
+ * @return physical block of @fileblock, 0 for a hole or negative on error
+ */
+long int read_allocated_run(struct ext2_inode *inode, int fileblock,
+			    int maxblocks, int *count,
+			    struct ext_block_cache *cache)
+{
+	struct ext4_extent_header *ext_block;
+	struct ext4_extent *extent;
+	struct ext_block_cache *c, cd;
+	long int startblock, endblock;
+	unsigned long long start;
+	int log2_blksz;
+	long int blknr;
+	int i;
+
+	*count = 1;
+	if (!(le32_to_cpu(inode->flags) & EXT4_EXTENTS_FL))
+		return read_indirect_block(inode, fileblock);
+
+	log2_blksz = LOG2_BLOCK_SIZE(ext4fs_root) -
+		get_fs()->dev_desc->log2blksz;
+	if (cache) {
+		c = cache;
+	} else {
+		c = &cd;
+		ext_cache_init(c);
+	}
+
+	ext_block = ext4fs_get_extent_block(ext4fs_root, c,
+					    (struct ext4_extent_header *)
+					    inode->b.blocks.dir_blocks,
+					    fileblock, log2_blksz);
+	if (!ext_block) {
+		printf("invalid extent block\n");
+		blknr = -EINVAL;
+		goto out;
+	}
+
+	/*
+	 * Past the last extent of this leaf it is a hole, but the next leaf
+	 * may start right after it, so that case maps a single block only.
+	 */
+	blknr = 0;
+	extent = (struct ext4_extent *)(ext_block + 1);
+
+	for (i = 0; i < le16_to_cpu(ext_block->eh_entries); i++) {
+		startblock = le32_to_cpu(extent[i].ee_block);
+		endblock = startblock + le16_to_cpu(extent[i].ee_len);
+
+		if (startblock > fileblock) {
+			/* Sparse file */
+			*count = min_t(long int, startblock - fileblock,
+				       maxblocks);
+			break;
+		} else if (fileblock < endblock) {
+			start = le16_to_cpu(extent[i].ee_start_hi);
+			start = (start << 32) +
+				le32_to_cpu(extent[i].ee_start_lo);
+			blknr = (fileblock - startblock) + start;
+			*count = min_t(long int, endblock - fileblock,
+				       maxblocks);
+			break;
+		}
+	}
+
+out:
+	if (!cache)
+		ext_cache_fini(c);
+	return blknr;
+}
+
+long int read_allocated_block(struct ext2_inode *inode, int fileblock,
+			      struct ext_block_cache *cache)
+{
+	int count;
+
+	return read_allocated_run(inode, fileblock, 1, &count, cache);
+}
+
 /**
  * ext4fs_reinit_global() - Reinitialize values of ext4 write implementation's
  *			    global pointers
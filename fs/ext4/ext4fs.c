@@ -47,6 +47,10 @@ void ext4fs_free_node(struct ext2fs_node *node, struct ext2fs_node *currroot)
  * Taken from openmoko-kernel mailing list: By Andy green
  * Optimized read file API : collects and defers contiguous sector
  * reads into one potentially more efficient larger sequential read action
+ *
+ * The file is walked one extent run at a time rather than block by block,
+ * and runs that follow each other on disk are merged into a single read
+ * straight into @buf.
  */
 int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 		loff_t len, char *buf, loff_t *actread)
@@ -58,13 +62,11 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 	int log2_fs_blocksize = LOG2_BLOCK_SIZE(node->data) - log2blksz;
 	int blocksize = (1 << (log2_fs_blocksize + log2blksz));
 	unsigned int filesize = le32_to_cpu(node->inode.size);
-	lbaint_t previous_block_number = -1;
 	lbaint_t delayed_start = 0;
 	lbaint_t delayed_extent = 0;
 	lbaint_t delayed_skipfirst = 0;
 	lbaint_t delayed_next = 0;
 	char *delayed_buf = NULL;
-	char *start_buf = buf;
 	short status;
 	struct ext_block_cache cache;
 
@@ -81,41 +83,38 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 
 	blockcnt = lldiv(((len + pos) + blocksize - 1), blocksize);
 
-	for (i = lldiv(pos, blocksize); i < blockcnt; i++) {
+	for (i = lldiv(pos, blocksize); i < blockcnt; ) {
 		long int blknr;
-		int blockoff = pos - (blocksize * i);
-		int blockend = blocksize;
-		int skipfirst = 0;
-		blknr = read_allocated_block(&node->inode, i, &cache);
+		int count;
+		loff_t start, end;
+		int skipfirst;
+
+		blknr = read_allocated_run(&node->inode, i, blockcnt - i,
+					   &count, &cache);
 		if (blknr < 0) {
 			ext_cache_fini(&cache);
 			return -1;
 		}
 
-		blknr = blknr << log2_fs_blocksize;
-
-		/* Last block.  */
-		if (i == blockcnt - 1) {
-			blockend = (len + pos) - (blocksize * i);
-
-			/* The last portion is exactly blocksize. */
-			if (!blockend)
-				blockend = blocksize;
+		/* Part of the file covered by this run */
+		start = (loff_t)i * blocksize;
+		end = (loff_t)(i + count) * blocksize;
+		skipfirst = 0;
+		if (start < pos) {
+			skipfirst = pos - start;
+			start = pos;
 		}
+		if (end > pos + len)
+			end = pos + len;
 
-		/* First block. */
-		if (i == lldiv(pos, blocksize)) {
-			skipfirst = blockoff;
-			blockend -= skipfirst;
-		}
 		if (blknr) {
-			int status;
+			blknr = blknr << log2_fs_blocksize;
 
-			if (previous_block_number != -1) {
-				if (delayed_next == blknr) {
-					delayed_extent += blockend;
-					delayed_next += blockend >> log2blksz;
-				} else {	/* spill */
+			if (delayed_extent && delayed_next == blknr &&
+			    !skipfirst) {
+				delayed_extent += end - start;
+			} else {
+				if (delayed_extent) {	/* spill */
 					status = ext4fs_devread(delayed_start,
 							delayed_skipfirst,
 							delayed_extent,
@@ -124,27 +123,15 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 						ext_cache_fini(&cache);
 						return -1;
 					}
-					previous_block_number = blknr;
-					delayed_start = blknr;
-					delayed_extent = blockend;
-					delayed_skipfirst = skipfirst;
-					delayed_buf = buf;
-					delayed_next = blknr +
-						(blockend >> log2blksz);
 				}
-			} else {
-				previous_block_number = blknr;
 				delayed_start = blknr;
-				delayed_extent = blockend;
+				delayed_extent = end - start;
 				delayed_skipfirst = skipfirst;
 				delayed_buf = buf;
-				delayed_next = blknr +
-					(blockend >> log2blksz);
 			}
+			delayed_next = blknr + (count << log2_fs_blocksize);
 		} else {
-			int n;
-			int n_left;
-			if (previous_block_number != -1) {
+			if (delayed_extent) {
 				/* spill */
 				status = ext4fs_devread(delayed_start,
 							delayed_skipfirst,
@@ -154,18 +141,15 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 					ext_cache_fini(&cache);
 					return -1;
 				}
-				previous_block_number = -1;
+				delayed_extent = 0;
 			}
-			/* Zero no more than `len' bytes. */
-			n = blocksize - skipfirst;
-			n_left = len - ( buf - start_buf );
-			if (n > n_left)
-				n = n_left;
-			memset(buf, 0, n);
+			/* Sparse run, zero the part of it that was asked for */
+			memset(buf, 0, end - start);
 		}
-		buf += blocksize - skipfirst;
+		buf += end - start;
+		i += count;
 	}
-	if (previous_block_number != -1) {
+	if (delayed_extent) {
 		/* spill */
 		status = ext4fs_devread(delayed_start,
 					delayed_skipfirst, delayed_extent,
@@ -174,7 +158,6 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 			ext_cache_fini(&cache);
 			return -1;
 		}
-		previous_block_number = -1;
 	}
 
 	*actread  = len;
@@ -444,23 +427,42 @@ void ext_cache_init(struct ext_block_cache *cache)
 
 void ext_cache_fini(struct ext_block_cache *cache)
 {
-	free(cache->buf);
+	int i;
+
+	for (i = 0; i < EXT_CACHE_ENTRIES; i++)
+		free(cache->entry[i].buf);
 	ext_cache_init(cache);
 }
 
 int ext_cache_read(struct ext_block_cache *cache, lbaint_t block, int size)
 {
-	/* This could be more lenient, but this is simple and enough for now */
-	if (cache->buf && cache->block == block && cache->size == size)
-		return 1;
-	ext_cache_fini(cache);
-	cache->buf = memalign(ARCH_DMA_MINALIGN, size);
-	if (!cache->buf)
+	int i, victim = 0;
+
+	for (i = 0; i < EXT_CACHE_ENTRIES; i++) {
+		if (cache->entry[i].buf && cache->entry[i].block == block &&
+		    cache->entry[i].size == size)
+			goto hit;
+		if (cache->entry[i].stamp < cache->entry[victim].stamp)
+			victim = i;
+	}
+
+	/* Miss, replace the least recently used (or an empty) entry */
+	i = victim;
+	free(cache->entry[i].buf);
+	cache->entry[i].buf = memalign(ARCH_DMA_MINALIGN, size);
+	cache->entry[i].stamp = 0;
+	if (!cache->entry[i].buf)
 		return 0;
-	if (!ext4fs_devread(block, 0, size, cache->buf)) {
-		ext_cache_fini(cache);
+	if (!ext4fs_devread(block, 0, size, cache->entry[i].buf)) {
+		free(cache->entry[i].buf);
+		cache->entry[i].buf = NULL;
 		return 0;
 	}
+	cache->entry[i].block = block;
+	cache->entry[i].size = size;
+hit:
+	cache->entry[i].stamp = ++cache->stamp;
+	cache->buf = cache->entry[i].buf;
 	cache->block = block;
 	cache->size = size;
 	return 1;
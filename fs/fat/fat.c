@@ -307,6 +307,34 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 	return 0;
 }
 
+/*
+ * Walk the cluster chain from 'clust' as long as the clusters are physically
+ * consecutive and fewer than 'size' bytes are covered. Return the number of
+ * bytes in that run (capped at 'size') and store the first cluster following
+ * it in '*next' (0 if the run reached 'size').
+ */
+static loff_t get_clust_run(fsdata *mydata, __u32 clust, loff_t size,
+			    __u32 *next)
+{
+	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
+	loff_t actsize = bytesperclust;
+	__u32 newclust;
+
+	*next = 0;
+	while (actsize < size) {
+		newclust = get_fatent(mydata, clust);
+		if (newclust != clust + 1 ||
+		    CHECK_CLUST(newclust, mydata->fatsize)) {
+			*next = newclust;
+			return actsize;
+		}
+		clust = newclust;
+		actsize += bytesperclust;
+	}
+
+	return size;
+}
+
 /*
  * Read at most 'maxsize' bytes from 'pos' in the file associated with 'dentptr'
  * into 'buffer'.
@@ -321,7 +349,7 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 	loff_t filesize = FAT2CPU32(dentptr->size);
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
 	__u32 curclust = START(dentptr);
-	__u32 endclust, newclust;
+	__u32 newclust;
 	loff_t actsize;
 
 	*gotsize = 0;
@@ -379,49 +407,25 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 		}
 	}
 
-	actsize = bytesperclust;
-	endclust = curclust;
-
 	do {
-		/* search for consecutive clusters */
-		while (actsize < filesize) {
-			newclust = get_fatent(mydata, endclust);
-			if ((newclust - 1) != endclust)
-				goto getit;
-			if (CHECK_CLUST(newclust, mydata->fatsize)) {
-				debug("curclust: 0x%x\n", newclust);
-				debug("Invalid FAT entry\n");
-				return 0;
-			}
-			endclust = newclust;
-			actsize += bytesperclust;
-		}
-
-		/* get remaining bytes */
-		actsize = filesize;
-		if (get_cluster(mydata, curclust, buffer, (int)actsize) != 0) {
+		actsize = get_clust_run(mydata, curclust, filesize, &newclust);
+		if (get_cluster(mydata, curclust, buffer,
+				(unsigned long)actsize) != 0) {
 			printf("Error reading cluster\n");
 			return -1;
 		}
 		*gotsize += actsize;
-		return 0;
-getit:
-		if (get_cluster(mydata, curclust, buffer, (int)actsize) != 0) {
-			printf("Error reading cluster\n");
-			return -1;
-		}
-		*gotsize += (int)actsize;
 		filesize -= actsize;
+		if (!filesize)
+			return 0;
 		buffer += actsize;
 
-		curclust = get_fatent(mydata, endclust);
+		curclust = newclust;
 		if (CHECK_CLUST(curclust, mydata->fatsize)) {
 			debug("curclust: 0x%x\n", curclust);
 			printf("Invalid FAT entry\n");
 			return 0;
 		}
-		actsize = bytesperclust;
-		endclust = curclust;
 	} while (1);
 }
 
@@ -85,6 +85,13 @@ void avb_sha256_init(AvbSHA256Ctx* ctx);
 /* Updates the SHA-256 context with |len| bytes from |data|. */
 void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, size_t len);
 
+/* Like avb_sha256_update() but may return while a hash engine is still
+ * reading |data|, which must stay unchanged until the next call on |ctx|.
+ */
+void avb_sha256_update_async(AvbSHA256Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len);
+
 /* Returns the SHA-256 digest. */
 uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) AVB_ATTR_WARN_UNUSED_RESULT;
 
@@ -94,6 +101,13 @@ void avb_sha512_init(AvbSHA512Ctx* ctx);
 /* Updates the SHA-512 context with |len| bytes from |data|. */
 void avb_sha512_update(AvbSHA512Ctx* ctx, const uint8_t* data, size_t len);
 
+/* Like avb_sha512_update() but may return while a hash engine is still
+ * reading |data|, which must stay unchanged until the next call on |ctx|.
+ */
+void avb_sha512_update_async(AvbSHA512Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len);
+
 /* Returns the SHA-512 digest. */
 uint8_t* avb_sha512_final(AvbSHA512Ctx* ctx) AVB_ATTR_WARN_UNUSED_RESULT;
 
@@ -85,6 +85,10 @@ struct dm_crypto_ops {
 	int (*sha_update)(struct udevice *dev, u32 *input, u32 len);
 	int (*sha_final)(struct udevice *dev, sha_context *ctx, u8 *output);
 
+	/* SHA update that returns once the engine is fed, and its wait */
+	int (*sha_update_async)(struct udevice *dev, u32 *input, u32 len);
+	int (*wait)(struct udevice *dev);
+
 	/* RSA verify */
 	int (*rsa_verify)(struct udevice *dev, rsa_key *ctx,
 			  u8 *sign, u8 *output);
@@ -146,6 +150,33 @@ int crypto_sha_init(struct udevice *dev, sha_context *ctx);
  */
 int crypto_sha_update(struct udevice *dev, u32 *input, u32 len);
 
+/**
+ * crypto_sha_update_async() - Crypto sha update without waiting the engine
+ *
+ * Hand @input to the hash engine and return while it may still be reading
+ * it, so the caller can fetch the next chunk meanwhile. @input must stay
+ * untouched until crypto_wait() or the next sha call on @dev returns.
+ * Devices without asynchronous support complete the update before
+ * returning.
+ *
+ * @dev: crypto device
+ * @input: input data buffer
+ * @len: input data length
+ *
+ * @return 0 on success, otherwise failed
+ */
+int crypto_sha_update_async(struct udevice *dev, u32 *input, u32 len);
+
+/**
+ * crypto_wait() - Wait for the asynchronous crypto job in flight
+ *
+ * @dev: crypto device
+ *
+ * @return 0 on success or when nothing is in flight, otherwise the error
+ * of the job that was in flight
+ */
+int crypto_wait(struct udevice *dev);
+
 /**
  * crypto_sha_final() - Crypto sha finish and get result
  *
@@ -117,10 +117,23 @@ struct ext_filesystem {
 	struct blk_desc *dev_desc;
 };
 
+#define EXT_CACHE_ENTRIES	8
+
+/*
+ * Small LRU of extent tree blocks. @buf, @block and @size describe the block
+ * returned by the last ext_cache_read().
+ */
 struct ext_block_cache {
 	char *buf;
 	lbaint_t block;
 	int size;
+	struct {
+		char *buf;
+		lbaint_t block;
+		int size;
+		unsigned int stamp;
+	} entry[EXT_CACHE_ENTRIES];
+	unsigned int stamp;
 };
 
 extern struct ext2_data *ext4fs_root;
@@ -157,6 +170,9 @@ int ext4fs_devread(lbaint_t sector, int byte_offset, int byte_len, char *buf);
 void ext4fs_set_blk_dev(struct blk_desc *rbdd, disk_partition_t *info);
 long int read_allocated_block(struct ext2_inode *inode, int fileblock,
 			      struct ext_block_cache *cache);
+long int read_allocated_run(struct ext2_inode *inode, int fileblock,
+			    int maxblocks, int *count,
+			    struct ext_block_cache *cache);
 int ext4fs_probe(struct blk_desc *fs_dev_desc,
 		 disk_partition_t *fs_partition);
 int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
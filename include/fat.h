@@ -25,7 +25,16 @@
 #define DIRENTSPERCLUST	((mydata->clust_size * mydata->sect_size) / \
 			 sizeof(dir_entry))
 
+/*
+ * Number of FAT sectors cached by get_fatent(). Must stay a multiple of 3 so
+ * that a FAT12 entry never straddles two cache windows. SPL keeps the small
+ * window as its malloc pool is usually tiny.
+ */
+#ifdef CONFIG_SPL_BUILD
 #define FATBUFBLOCKS	6
+#else
+#define FATBUFBLOCKS	48
+#endif
 #define FATBUFSIZE	(mydata->sect_size * FATBUFBLOCKS)
 #define FAT12BUFSIZE	((FATBUFSIZE*2)/3)
 #define FAT16BUFSIZE	(FATBUFSIZE/2)
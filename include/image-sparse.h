@@ -23,6 +23,15 @@ struct sparse_storage {
 	lbaint_t	(*reserve)(struct sparse_storage *info,
 				 lbaint_t blk,
 				 lbaint_t blkcnt);
+
+	/*
+	 * Optional: erase blocks so that they read back as zeroes. Ranges
+	 * passed in are aligned to erase_grp blocks (a power of two).
+	 */
+	lbaint_t	(*erase)(struct sparse_storage *info,
+				 lbaint_t blk,
+				 lbaint_t blkcnt);
+	lbaint_t	erase_grp;
 };
 
 static inline int is_sparse_image(void *buf)
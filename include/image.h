@@ -915,11 +915,16 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 #define FIT_IGNORE_PROP		"uboot-ignore"
 #define FIT_SIG_NODENAME	"signature"
 
+/* cipher node */
+#define FIT_CIPHER_NODENAME	"cipher"
+#define FIT_KEY_HINT		"key-name-hint"
+
 /* image node */
 #define FIT_DATA_PROP		"data"
 #define FIT_DATA_POSITION_PROP	"data-position"
 #define FIT_DATA_OFFSET_PROP	"data-offset"
 #define FIT_DATA_SIZE_PROP	"data-size"
+#define FIT_DATA_SIZE_UNCIPHERED_PROP	"data-size-unciphered"
 #define FIT_TIMESTAMP_PROP	"timestamp"
 #define FIT_TOTALSIZE_PROP	"totalsize"
 #define FIT_VERSION_PROP	"version"
@@ -1065,6 +1070,20 @@ int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 int fit_image_verify_with_data(const void *fit, int image_noffset,
 			       const void *data, size_t size);
 int fit_image_verify(const void *fit, int noffset);
+
+/**
+ * fit_image_uncipher() - Decrypt image data in place
+ *
+ * Data of an image node without a "cipher" subnode is left as it is.
+ *
+ * @fit:	FIT to check
+ * @noffset:	offset of the image node
+ * @data:	verified image data, decrypted in place
+ * @size:	size of @data, updated to the plain data size
+ * @return 0 if OK, -ve on error
+ */
+int fit_image_uncipher(const void *fit, int noffset, void *data,
+		       size_t *size);
 int fit_config_verify(const void *fit, int conf_noffset);
 int fit_all_image_verify(const void *fit);
 int fit_board_verify_required_sigs(void);
@@ -1392,6 +1411,34 @@ long android_image_load(struct blk_desc *dev_desc,
 int android_image_load_by_partname(struct blk_desc *dev_desc,
 				   const char *boot_partname,
 				   unsigned long *load_address);
+
+/**
+ * android_image_preload_add() - Register a partition which is fully in memory
+ *
+ * The image loading code takes sub-images of a registered partition from
+ * memory instead of reading them from storage again. The caller owns the
+ * buffer and must call android_image_preload_clear() before freeing it.
+ *
+ * @part_name:	partition name without slot suffix, eg. "vendor_boot"
+ * @addr:	start of the partition data in memory
+ * @size:	number of valid bytes at @addr
+ * @return 0 on success, -ENOSPC if the registry is full, other -ve on error
+ */
+int android_image_preload_add(const char *part_name, void *addr, ulong size);
+
+/**
+ * android_image_preload_get() - Look up a preloaded partition
+ *
+ * @part_name:	partition name without slot suffix
+ * @size:	returns the number of valid bytes, may be NULL
+ * @return the partition data in memory, or NULL if it is not preloaded
+ */
+void *android_image_preload_get(const char *part_name, ulong *size);
+
+/**
+ * android_image_preload_clear() - Forget all preloaded partitions
+ */
+void android_image_preload_clear(void);
 #endif /* CONFIG_ANDROID_BOOT_IMAGE */
 
 int bootm_parse_comp(const unsigned char *hdr);
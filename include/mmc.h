@@ -187,6 +187,7 @@
 #define EXT_CSD_ERASE_GROUP_DEF		175	/* R/W */
 #define EXT_CSD_BOOT_BUS_WIDTH		177
 #define EXT_CSD_PART_CONF		179	/* R/W */
+#define EXT_CSD_ERASED_MEM_CONT		181	/* RO */
 #define EXT_CSD_BUS_WIDTH		183	/* R/W */
 #define EXT_CSD_STROBE_SUPPORT		184	/* RO */
 #define EXT_CSD_HS_TIMING		185	/* R/W */
@@ -359,6 +360,7 @@ struct mmc_uclass_priv {
 
 struct emmc_esr {
 	unsigned int mmc_can_trim;
+	unsigned int erased_mem_cont;	/* erased blocks read as 0 or 1 */
 };
 
 /**
@@ -91,4 +91,32 @@ int nvme_print_info(struct udevice *udev);
  */
 int nvme_get_namespace_id(struct udevice *udev, u32 *ns_id, u8 *eui64);
 
+/**
+ * nvme_blk_read_async - start reading blocks without waiting for them
+ *
+ * This queues a read on an NVMe block device and returns as soon as the
+ * first commands are issued, so that several images can be loaded with
+ * their reads overlapping. The buffer must not be touched until
+ * nvme_blk_wait() has returned for the handle.
+ *
+ * @udev:	NVMe block device
+ * @blknr:	first block to read
+ * @blkcnt:	number of blocks to read
+ * @buffer:	buffer to read into
+ * @return:	handle to pass to nvme_blk_wait() on success, -EINVAL if
+ *		@udev is not an NVMe block device, -EBUSY if too many reads
+ *		are outstanding
+ */
+int nvme_blk_read_async(struct udevice *udev, lbaint_t blknr,
+			lbaint_t blkcnt, void *buffer);
+
+/**
+ * nvme_blk_wait - wait for a read started by nvme_blk_read_async()
+ *
+ * @udev:	NVMe block device the read was started on
+ * @handle:	handle returned by nvme_blk_read_async()
+ * @return:	number of blocks read before the first error
+ */
+ulong nvme_blk_wait(struct udevice *udev, int handle);
+
 #endif /* __NVME_H__ */
@@ -37,6 +37,14 @@
 #include <android_avb/avb_util.h>
 #include <android_avb/avb_vbmeta_image.h>
 
+/* The Rockchip crypto v1 PKA needs a precomputed factor which is not part
+ * of an AVB key, the v2 one computes it by itself.
+ */
+#if defined(CONFIG_DM_CRYPTO) && !defined(CONFIG_ROCKCHIP_CRYPTO_V1)
+#include <crypto.h>
+#define AVB_RSA_USE_CRYPTO_DEV
+#endif
+
 typedef struct IAvbKey {
   unsigned int len; /* Length of n[] in number of uint32_t */
   uint32_t n0inv;   /* -1 / n[0] mod 2^32 */
@@ -225,6 +233,77 @@ out:
   }
 }
 
+#ifdef AVB_RSA_USE_CRYPTO_DEV
+/* Same as modpowF4() but done by a crypto device, if there is one which can
+ * do RSA for this key size. Returns false if there is none or it failed, in
+ * which case |inout| is left untouched.
+ */
+static bool modpowF4_crypto(const IAvbKey* key, uint8_t* inout) {
+  size_t num_bytes = key->len * sizeof(uint32_t);
+  struct udevice* dev;
+  rsa_key rsa_key;
+  uint32_t* e = NULL;
+  uint8_t* m = NULL;
+  uint8_t* out = NULL;
+  bool success = false;
+  size_t i;
+
+  switch (key->len * 32) {
+    case 2048:
+      rsa_key.algo = CRYPTO_RSA2048;
+      break;
+    case 4096:
+      rsa_key.algo = CRYPTO_RSA4096;
+      break;
+    default:
+      return false;
+  }
+
+  dev = crypto_get_device(rsa_key.algo);
+  if (dev == NULL) {
+    return false;
+  }
+
+  e = (uint32_t*)avb_calloc(num_bytes);
+  m = (uint8_t*)avb_malloc(num_bytes);
+  out = (uint8_t*)avb_malloc(num_bytes);
+  if (e == NULL || m == NULL || out == NULL) {
+    goto out;
+  }
+
+  /* The device takes little endian numbers: n is already in that form. */
+  e[0] = 65537;
+  rsa_key.n = key->n;
+  rsa_key.e = e;
+  rsa_key.c = NULL;
+  for (i = 0; i < num_bytes; i++) {
+    m[i] = inout[num_bytes - 1 - i];
+  }
+
+  if (crypto_rsa_verify(dev, &rsa_key, m, out) != 0) {
+    avb_debug("RSA on crypto device failed, using software.\n");
+    goto out;
+  }
+
+  for (i = 0; i < num_bytes; i++) {
+    inout[i] = out[num_bytes - 1 - i];
+  }
+  success = true;
+
+out:
+  if (e != NULL) {
+    avb_free(e);
+  }
+  if (m != NULL) {
+    avb_free(m);
+  }
+  if (out != NULL) {
+    avb_free(out);
+  }
+  return success;
+}
+#endif
+
 /* Verify a RSA PKCS1.5 signature against an expected hash.
  * Returns false on failure, true on success.
  */
@@ -268,7 +347,10 @@ bool avb_rsa_verify(const uint8_t* key,
   }
   avb_memcpy(buf, sig, sig_num_bytes);
 
-  modpowF4(parsed_key, buf);
+#ifdef AVB_RSA_USE_CRYPTO_DEV
+  if (!modpowF4_crypto(parsed_key, buf))
+#endif
+    modpowF4(parsed_key, buf);
 
   /* Check padding bytes.
    *
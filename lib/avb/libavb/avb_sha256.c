@@ -56,6 +56,13 @@ void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, size_t len) {
     crypto_sha_update(ctx->crypto_dev, (u32 *)data, len);
 }
 
+void avb_sha256_update_async(AvbSHA256Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len) {
+  if (ctx->crypto_dev)
+    crypto_sha_update_async(ctx->crypto_dev, (u32 *)data, len);
+}
+
 uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
   if (ctx->crypto_dev)
     crypto_sha_final(ctx->crypto_dev, &ctx->crypto_ctx, ctx->buf);
@@ -389,6 +396,12 @@ void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, size_t len) {
   ctx->tot_len += (block_nb + 1) << 6;
 }
 
+void avb_sha256_update_async(AvbSHA256Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len) {
+  avb_sha256_update(ctx, data, len);
+}
+
 uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
   size_t block_nb;
   size_t pm_len;
@@ -57,6 +57,13 @@ void avb_sha512_update(AvbSHA512Ctx* ctx, const uint8_t* data, size_t len) {
     crypto_sha_update(ctx->crypto_dev, (u32 *)data, len);
 }
 
+void avb_sha512_update_async(AvbSHA512Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len) {
+  if (ctx->crypto_dev)
+    crypto_sha_update_async(ctx->crypto_dev, (u32 *)data, len);
+}
+
 uint8_t* avb_sha512_final(AvbSHA512Ctx* ctx) {
   if (ctx->crypto_dev)
     crypto_sha_final(ctx->crypto_dev, &ctx->crypto_ctx, ctx->buf);
@@ -377,6 +384,12 @@ void avb_sha512_update(AvbSHA512Ctx* ctx, const uint8_t* data, size_t len) {
   ctx->tot_len += (block_nb + 1) << 7;
 }
 
+void avb_sha512_update_async(AvbSHA512Ctx* ctx,
+                            const uint8_t* data,
+                            size_t len) {
+  avb_sha512_update(ctx, data, len);
+}
+
 uint8_t* avb_sha512_final(AvbSHA512Ctx* ctx) {
   size_t block_nb;
   size_t pm_len;
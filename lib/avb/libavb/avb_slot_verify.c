@@ -44,6 +44,78 @@
 /* Maximum size of a vbmeta image - 64 KiB. */
 #define VBMETA_MAX_SIZE (64 * 1024)
 
+/* Size of each read when a partition is hashed while it is loaded - 4 MiB.
+ * Every read_from_partition() call looks the partition up again, so keep
+ * the chunks large enough for that to stay in the noise.
+ */
+#define HASH_READ_CHUNK_SIZE (4 * 1024 * 1024)
+
+/* Digest state for a partition which is hashed as it is read by
+ * load_full_partition(). The digest covers |salt| followed by the first
+ * |size_to_hash| bytes of the partition. It is only started once the
+ * partition is known not to be preloaded, so a hardware hash engine is
+ * never left with a half-done digest.
+ */
+typedef struct {
+  bool use_sha512;
+  const uint8_t* salt;
+  size_t salt_len;
+  uint64_t size_to_hash;
+  uint64_t hashed;
+  AvbSHA256Ctx sha256_ctx;
+  AvbSHA512Ctx sha512_ctx;
+} PartitionHasher;
+
+static void partition_hasher_update(PartitionHasher* hasher,
+                                    const uint8_t* data,
+                                    size_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (hasher->use_sha512) {
+    avb_sha512_update(&hasher->sha512_ctx, data, len);
+  } else {
+    avb_sha256_update(&hasher->sha256_ctx, data, len);
+  }
+}
+
+/* Feeds a chunk which stays in place until the digest is finalized, so a
+ * hash engine may still be reading it while the next chunk is loaded.
+ */
+static void partition_hasher_update_async(PartitionHasher* hasher,
+                                          const uint8_t* data,
+                                          size_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (hasher->use_sha512) {
+    avb_sha512_update_async(&hasher->sha512_ctx, data, len);
+  } else {
+    avb_sha256_update_async(&hasher->sha256_ctx, data, len);
+  }
+}
+
+static void partition_hasher_start(PartitionHasher* hasher) {
+  uint64_t tot_len = hasher->salt_len + hasher->size_to_hash;
+
+  if (hasher->use_sha512) {
+    hasher->sha512_ctx.tot_len = tot_len;
+    avb_sha512_init(&hasher->sha512_ctx);
+  } else {
+    hasher->sha256_ctx.tot_len = tot_len;
+    avb_sha256_init(&hasher->sha256_ctx);
+  }
+  hasher->hashed = 0;
+  partition_hasher_update(hasher, hasher->salt, hasher->salt_len);
+}
+
+static uint8_t* partition_hasher_final(PartitionHasher* hasher) {
+  if (hasher->use_sha512) {
+    return avb_sha512_final(&hasher->sha512_ctx);
+  }
+  return avb_sha256_final(&hasher->sha256_ctx);
+}
+
 static AvbSlotVerifyResult initialize_persistent_digest(
     AvbOps* ops,
     const char* part_name,
@@ -80,8 +152,12 @@ static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
                                                uint64_t image_size,
                                                uint8_t** out_image_buf,
                                                bool* out_image_preloaded,
-                                               int allow_verification_error) {
+                                               int allow_verification_error,
+                                               PartitionHasher* hasher) {
   size_t part_num_read;
+  size_t chunk_size;
+  size_t num_to_read;
+  uint64_t offset;
   AvbIOResult io_ret;
 
   /* Make sure that we do not overwrite existing data. */
@@ -123,21 +199,47 @@ static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
       return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
     }
 
-    io_ret = ops->read_from_partition(ops,
-                                      part_name,
-                                      0 /* offset */,
-                                      image_size,
-                                      *out_image_buf,
-                                      &part_num_read);
-    if (io_ret == AVB_IO_RESULT_ERROR_OOM) {
-      return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
-    } else if (io_ret != AVB_IO_RESULT_OK) {
-      avb_errorv(part_name, ": Error loading data from partition.\n", NULL);
-      return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+    /* Without a hasher the partition is read in one go. Otherwise read it
+     * in chunks and hash each chunk right after it lands, so the digest is
+     * ready as soon as the last chunk has been read.
+     */
+    chunk_size = image_size;
+    if (hasher != NULL) {
+      chunk_size = HASH_READ_CHUNK_SIZE;
+      partition_hasher_start(hasher);
     }
-    if (part_num_read != image_size) {
-      avb_errorv(part_name, ": Read incorrect number of bytes.\n", NULL);
-      return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+    for (offset = 0; offset < image_size; offset += num_to_read) {
+      num_to_read = image_size - offset;
+      if (num_to_read > chunk_size) {
+        num_to_read = chunk_size;
+      }
+
+      io_ret = ops->read_from_partition(ops,
+                                        part_name,
+                                        offset,
+                                        num_to_read,
+                                        *out_image_buf + offset,
+                                        &part_num_read);
+      if (io_ret == AVB_IO_RESULT_ERROR_OOM) {
+        return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
+      } else if (io_ret != AVB_IO_RESULT_OK) {
+        avb_errorv(part_name, ": Error loading data from partition.\n", NULL);
+        return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+      }
+      if (part_num_read != num_to_read) {
+        avb_errorv(part_name, ": Read incorrect number of bytes.\n", NULL);
+        return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+      }
+
+      if (hasher != NULL && hasher->hashed < hasher->size_to_hash) {
+        size_t num_to_hash = hasher->size_to_hash - hasher->hashed;
+        if (num_to_hash > num_to_read) {
+          num_to_hash = num_to_read;
+        }
+        partition_hasher_update_async(
+            hasher, *out_image_buf + hasher->hashed, num_to_hash);
+        hasher->hashed += num_to_hash;
+      }
     }
   }
 
@@ -294,6 +396,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
   AvbIOResult io_ret;
   uint8_t* image_buf = NULL;
   bool image_preloaded = false;
+  PartitionHasher hasher;
   uint8_t* digest;
   size_t digest_len;
   const char* found = NULL;
@@ -383,45 +486,38 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     avb_debugv(part_name, ": Loading entire partition.\n", NULL);
   }
 
-  ret = load_full_partition(
-      ops, part_name, image_size, &image_buf, &image_preloaded,
-      allow_verification_error);
-  if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
-    goto out;
-  } else if (image_preloaded) {
-    goto out;
-  }
-
-  // Although only one of the type might be used, we have to defined the
-  // structure here so that they would live outside the 'if/else' scope to be
-  // used later.
-  AvbSHA256Ctx sha256_ctx;
-  AvbSHA512Ctx sha512_ctx;
-  size_t image_size_to_hash = hash_desc.image_size;
-  // If we allow verification error and the whole partition is smaller than
-  // image size in hash descriptor, we just hash the whole partition.
-  if (image_size_to_hash > image_size) {
-    image_size_to_hash = image_size;
+  /* If we allow verification error and the whole partition is smaller than
+   * image size in hash descriptor, we just hash the whole partition.
+   */
+  hasher.size_to_hash = hash_desc.image_size;
+  if (hasher.size_to_hash > image_size) {
+    hasher.size_to_hash = image_size;
   }
   if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
-    sha256_ctx.tot_len = hash_desc.salt_len + image_size_to_hash;
-    avb_sha256_init(&sha256_ctx);
-    avb_sha256_update(&sha256_ctx, desc_salt, hash_desc.salt_len);
-    avb_sha256_update(&sha256_ctx, image_buf, image_size_to_hash);
-    digest = avb_sha256_final(&sha256_ctx);
+    hasher.use_sha512 = false;
     digest_len = AVB_SHA256_DIGEST_SIZE;
   } else if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha512") == 0) {
-    sha512_ctx.tot_len = hash_desc.salt_len + image_size_to_hash;
-    avb_sha512_init(&sha512_ctx);
-    avb_sha512_update(&sha512_ctx, desc_salt, hash_desc.salt_len);
-    avb_sha512_update(&sha512_ctx, image_buf, image_size_to_hash);
-    digest = avb_sha512_final(&sha512_ctx);
+    hasher.use_sha512 = true;
     digest_len = AVB_SHA512_DIGEST_SIZE;
   } else {
     avb_errorv(part_name, ": Unsupported hash algorithm.\n", NULL);
     ret = AVB_SLOT_VERIFY_RESULT_ERROR_INVALID_METADATA;
     goto out;
   }
+  hasher.salt = desc_salt;
+  hasher.salt_len = hash_desc.salt_len;
+
+  /* The partition data is hashed chunk by chunk while it is being read. */
+  ret = load_full_partition(
+      ops, part_name, image_size, &image_buf, &image_preloaded,
+      allow_verification_error, &hasher);
+  if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
+    goto out;
+  } else if (image_preloaded) {
+    goto out;
+  }
+
+  digest = partition_hasher_final(&hasher);
 
   if (hash_desc.digest_len == 0) {
     /* Expect a match to a persistent digest. */
@@ -526,7 +622,7 @@ static AvbSlotVerifyResult load_requested_partitions(
     avb_debugv(part_name, ": Loading entire partition.\n", NULL);
 
     ret = load_full_partition(
-        ops, part_name, image_size, &image_buf, &image_preloaded, 1);
+        ops, part_name, image_size, &image_buf, &image_preloaded, 1, NULL);
     if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
       goto out;
     }
@@ -20,29 +20,74 @@
 #include <u-boot/rsa.h>
 #include <u-boot/rsa-mod-exp.h>
 
-#define UINT64_MULT32(v, multby)  (((uint64_t)(v)) * ((uint32_t)(multby)))
-
-#define get_unaligned_be32(a) fdt32_to_cpu(*(uint32_t *)a)
-#define put_unaligned_be32(a, b) (*(uint32_t *)(b) = cpu_to_fdt32(a))
+#ifndef USE_HOSTCC
+DECLARE_GLOBAL_DATA_PTR;
+#endif
 
 /* Default public exponent for backward compatibility */
 #define RSA_DEFAULT_PUBEXP	65537
 
+/*
+ * The Montgomery arithmetic works on limbs of the native word size. With a
+ * 64x64->128 multiply (MUL/UMULH on AArch64) a 2048-bit modulus is 32 limbs
+ * instead of 64, so a multiplication takes a quarter of the inner steps.
+ */
+#ifdef __SIZEOF_INT128__
+typedef uint64_t rsa_limb_t;
+typedef unsigned __int128 rsa_dlimb_t;
+#else
+typedef uint32_t rsa_limb_t;
+typedef uint64_t rsa_dlimb_t;
+#endif
+
+#define RSA_LIMB_BITS		(sizeof(rsa_limb_t) * 8)
+#define RSA_LIMB_BYTES		sizeof(rsa_limb_t)
+#define RSA_MAX_LIMBS		(RSA_MAX_KEY_BITS / RSA_LIMB_BITS)
+
+/* Number of public keys kept in their Montgomery form */
+#define RSA_KEY_CACHE_SIZE	2
+
+/**
+ * struct rsa_mont_key - public key converted for Montgomery arithmetic
+ *
+ * @prop_modulus:	The key_prop modulus this was converted from
+ * @num_bits:		Key length in bits
+ * @len:		Length of modulus[] and rr[] in limbs
+ * @n0inv:		-1 / modulus[0] mod 2^RSA_LIMB_BITS
+ * @exponent:		Public exponent
+ * @modulus:		Modulus as little endian limb array
+ * @rr:			R^2 mod modulus, R = 2^(RSA_LIMB_BITS * len), as
+ *			little endian limb array
+ */
+struct rsa_mont_key {
+	const void *prop_modulus;
+	uint num_bits;
+	uint len;
+	rsa_limb_t n0inv;
+	uint64_t exponent;
+	rsa_limb_t modulus[RSA_MAX_LIMBS];
+	rsa_limb_t rr[RSA_MAX_LIMBS];
+};
+
+static struct rsa_mont_key rsa_key_cache[RSA_KEY_CACHE_SIZE];
+static uint rsa_key_cache_next;
+
 /**
  * subtract_modulus() - subtract modulus from the given value
  *
  * @key:	Key containing modulus to subtract
- * @num:	Number to subtract modulus from, as little endian word array
+ * @num:	Number to subtract modulus from, as little endian limb array
  */
-static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
+static void subtract_modulus(const struct rsa_mont_key *key, rsa_limb_t num[])
 {
-	int64_t acc = 0;
+	rsa_limb_t borrow = 0;
 	uint i;
 
 	for (i = 0; i < key->len; i++) {
-		acc += (uint64_t)num[i] - key->modulus[i];
-		num[i] = (uint32_t)acc;
-		acc >>= 32;
+		rsa_dlimb_t acc = (rsa_dlimb_t)num[i] - key->modulus[i] - borrow;
+
+		num[i] = (rsa_limb_t)acc;
+		borrow = (rsa_limb_t)(acc >> RSA_LIMB_BITS) & 1;
 	}
 }
 
@@ -50,11 +95,11 @@ static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
  * greater_equal_modulus() - check if a value is >= modulus
  *
  * @key:	Key containing modulus to check
- * @num:	Number to check against modulus, as little endian word array
+ * @num:	Number to check against modulus, as little endian limb array
  * @return 0 if num < modulus, 1 if num >= modulus
  */
-static int greater_equal_modulus(const struct rsa_public_key *key,
-				 uint32_t num[])
+static int greater_equal_modulus(const struct rsa_mont_key *key,
+				 rsa_limb_t num[])
 {
 	int i;
 
@@ -74,32 +119,34 @@ static int greater_equal_modulus(const struct rsa_public_key *key,
  * Operation: montgomery result[] += a * b[] / n0inv % modulus
  *
  * @key:	RSA key
- * @result:	Place to put result, as little endian word array
+ * @result:	Place to put result, as little endian limb array
  * @a:		Multiplier
- * @b:		Multiplicand, as little endian word array
+ * @b:		Multiplicand, as little endian limb array
  */
-static void montgomery_mul_add_step(const struct rsa_public_key *key,
-		uint32_t result[], const uint32_t a, const uint32_t b[])
+static void montgomery_mul_add_step(const struct rsa_mont_key *key,
+		rsa_limb_t result[], const rsa_limb_t a, const rsa_limb_t b[])
 {
-	uint64_t acc_a, acc_b;
-	uint32_t d0;
+	rsa_dlimb_t acc_a, acc_b;
+	rsa_limb_t d0;
 	uint i;
 
-	acc_a = (uint64_t)a * b[0] + result[0];
-	d0 = (uint32_t)acc_a * key->n0inv;
-	acc_b = (uint64_t)d0 * key->modulus[0] + (uint32_t)acc_a;
+	acc_a = (rsa_dlimb_t)a * b[0] + result[0];
+	d0 = (rsa_limb_t)acc_a * key->n0inv;
+	acc_b = (rsa_dlimb_t)d0 * key->modulus[0] + (rsa_limb_t)acc_a;
 	for (i = 1; i < key->len; i++) {
-		acc_a = (acc_a >> 32) + (uint64_t)a * b[i] + result[i];
-		acc_b = (acc_b >> 32) + (uint64_t)d0 * key->modulus[i] +
-				(uint32_t)acc_a;
-		result[i - 1] = (uint32_t)acc_b;
+		acc_a = (acc_a >> RSA_LIMB_BITS) + (rsa_dlimb_t)a * b[i] +
+				result[i];
+		acc_b = (acc_b >> RSA_LIMB_BITS) +
+				(rsa_dlimb_t)d0 * key->modulus[i] +
+				(rsa_limb_t)acc_a;
+		result[i - 1] = (rsa_limb_t)acc_b;
 	}
 
-	acc_a = (acc_a >> 32) + (acc_b >> 32);
+	acc_a = (acc_a >> RSA_LIMB_BITS) + (acc_b >> RSA_LIMB_BITS);
 
-	result[i - 1] = (uint32_t)acc_a;
+	result[i - 1] = (rsa_limb_t)acc_a;
 
-	if (acc_a >> 32)
+	if (acc_a >> RSA_LIMB_BITS)
 		subtract_modulus(key, result);
 }
 
@@ -109,12 +156,12 @@ static void montgomery_mul_add_step(const struct rsa_public_key *key,
  * Operation: montgomery result[] = a[] * b[] / n0inv % modulus
  *
  * @key:	RSA key
- * @result:	Place to put result, as little endian word array
- * @a:		Multiplier, as little endian word array
- * @b:		Multiplicand, as little endian word array
+ * @result:	Place to put result, as little endian limb array
+ * @a:		Multiplier, as little endian limb array
+ * @b:		Multiplicand, as little endian limb array
  */
-static void montgomery_mul(const struct rsa_public_key *key,
-		uint32_t result[], uint32_t a[], const uint32_t b[])
+static void montgomery_mul(const struct rsa_mont_key *key,
+		rsa_limb_t result[], rsa_limb_t a[], const rsa_limb_t b[])
 {
 	uint i;
 
@@ -130,7 +177,7 @@ static void montgomery_mul(const struct rsa_public_key *key,
  * @key:	RSA key
  * @num_bits:	Storage for the number of public exponent bits
  */
-static int num_public_exponent_bits(const struct rsa_public_key *key,
+static int num_public_exponent_bits(const struct rsa_mont_key *key,
 		int *num_bits)
 {
 	uint64_t exponent;
@@ -160,38 +207,73 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
  * @key:	RSA key
  * @pos:	The bit position to check
  */
-static int is_public_exponent_bit_set(const struct rsa_public_key *key,
+static int is_public_exponent_bit_set(const struct rsa_mont_key *key,
 		int pos)
 {
 	return key->exponent & (1ULL << pos);
 }
 
 /**
- * pow_mod() - in-place public exponentiation
+ * be_to_limb() - Get one limb of a big endian byte array
+ *
+ * @src:	Big endian byte array
+ * @src_len:	Length of @src in bytes
+ * @pos:	Limb index, 0 being the least significant one
+ * @return the limb, zero-extended if it is beyond the top of @src
+ */
+static rsa_limb_t be_to_limb(const uint8_t *src, uint src_len, uint pos)
+{
+	rsa_limb_t limb = 0;
+	uint i, off;
+
+	for (i = 0; i < RSA_LIMB_BYTES; i++) {
+		off = pos * RSA_LIMB_BYTES + i;
+		if (off >= src_len)
+			break;
+		limb |= (rsa_limb_t)src[src_len - 1 - off] << (i * 8);
+	}
+
+	return limb;
+}
+
+/**
+ * limbs_to_be() - Convert a little endian limb array to big endian bytes
+ *
+ * @dst:	Big endian byte array
+ * @dst_len:	Length of @dst in bytes
+ * @src:	Little endian limb array, long enough to cover @dst_len
+ */
+static void limbs_to_be(uint8_t *dst, uint dst_len, const rsa_limb_t src[])
+{
+	uint i;
+
+	for (i = 0; i < dst_len; i++)
+		dst[dst_len - 1 - i] = src[i / RSA_LIMB_BYTES] >>
+				       ((i % RSA_LIMB_BYTES) * 8);
+}
+
+/**
+ * pow_mod() - public exponentiation
  *
  * @key:	RSA key
- * @inout:	Big-endian word array containing value and result
+ * @in:		Big endian byte array with the value, key->num_bits / 8 long
+ * @out:	Big endian byte array for the result, key->num_bits / 8 long
  */
-static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
+static int pow_mod(const struct rsa_mont_key *key, const uint8_t *in,
+		   uint8_t *out)
 {
-	uint32_t *result, *ptr;
+	uint nbytes = key->num_bits / 8;
+	rsa_limb_t *result;
 	uint i;
 	int j, k;
 
-	/* Sanity check for stack size - key->len is in 32-bit words */
-	if (key->len > RSA_MAX_KEY_BITS / 32) {
-		debug("RSA key words %u exceeds maximum %d\n", key->len,
-		      RSA_MAX_KEY_BITS / 32);
-		return -EINVAL;
-	}
-
-	uint32_t val[key->len], acc[key->len], tmp[key->len];
-	uint32_t a_scaled[key->len];
+	rsa_limb_t val[key->len], acc[key->len], tmp[key->len];
+	rsa_limb_t a_scaled[key->len];
 	result = tmp;  /* Re-use location. */
 
-	/* Convert from big endian byte array to little endian word array. */
-	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
-		val[i] = get_unaligned_be32(ptr);
+	/* Convert from big endian byte array to little endian limb array. */
+	for (i = 0; i < key->len; i++)
+		val[i] = be_to_limb(in, nbytes, i);
 
 	if (0 != num_public_exponent_bits(key, &k))
 		return -EINVAL;
@@ -234,17 +316,126 @@ static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
 		subtract_modulus(key, result);
 
 	/* Convert to bigendian byte array */
-	for (i = key->len - 1, ptr = inout; (int)i >= 0; i--, ptr++)
-		put_unaligned_be32(result[i], ptr);
+	limbs_to_be(out, nbytes, result);
+
 	return 0;
 }
 
-static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
+/**
+ * rsa_mont_key_matches() - Check if a converted key is the one in @prop
+ *
+ * The key properties are looked up in the FDT for each verify, so they
+ * normally point at the same property as last time. The modulus is still
+ * compared in full, converting it costs next to nothing next to pow_mod().
+ */
+static bool rsa_mont_key_matches(const struct rsa_mont_key *key,
+				 const struct key_prop *prop,
+				 uint64_t exponent)
 {
-	int i;
+	uint nbytes = prop->num_bits / 8;
+	uint i;
+
+	if (!key->len || key->prop_modulus != prop->modulus ||
+	    key->num_bits != prop->num_bits || key->exponent != exponent)
+		return false;
+
+	for (i = 0; i < key->len; i++) {
+		if (key->modulus[i] != be_to_limb(prop->modulus, nbytes, i))
+			return false;
+	}
 
-	for (i = 0; i < len; i++)
-		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
+	return true;
+}
+
+/**
+ * rsa_mont_key_init() - Convert a public key for Montgomery arithmetic
+ *
+ * @key:	Key to fill in
+ * @prop:	Key properties, prop->num_bits must be a multiple of 32
+ * @exponent:	Public exponent
+ */
+static void rsa_mont_key_init(struct rsa_mont_key *key,
+			      const struct key_prop *prop, uint64_t exponent)
+{
+	uint nbytes = prop->num_bits / 8;
+	rsa_limb_t inv, carry;
+	uint i, shift;
+
+	key->prop_modulus = prop->modulus;
+	key->num_bits = prop->num_bits;
+	key->len = (prop->num_bits + RSA_LIMB_BITS - 1) / RSA_LIMB_BITS;
+	key->exponent = exponent;
+
+	for (i = 0; i < key->len; i++) {
+		key->modulus[i] = be_to_limb(prop->modulus, nbytes, i);
+		key->rr[i] = be_to_limb(prop->rr, nbytes, i);
+	}
+
+	/*
+	 * -1 / modulus[0] by Newton's iteration, every step doubles the
+	 * number of correct low bits. prop->n0inv is only good for 32 bits.
+	 */
+	inv = key->modulus[0];	/* correct to 3 bits as modulus is odd */
+	for (i = 3; i < RSA_LIMB_BITS; i *= 2)
+		inv *= 2 - key->modulus[0] * inv;
+	key->n0inv = -inv;
+
+	/*
+	 * rsa,r-squared is R^2 for R = 2^num_bits. If the key does not fill
+	 * the top limb, R is larger by 2^shift and R^2 by 2^(2 * shift):
+	 * double rr that many times, reducing modulo the modulus each time.
+	 */
+	shift = key->len * RSA_LIMB_BITS - prop->num_bits;
+	for (shift *= 2; shift; shift--) {
+		carry = 0;
+		for (i = 0; i < key->len; i++) {
+			rsa_limb_t top = key->rr[i] >> (RSA_LIMB_BITS - 1);
+
+			key->rr[i] = (key->rr[i] << 1) | carry;
+			carry = top;
+		}
+		if (carry || greater_equal_modulus(key, key->rr))
+			subtract_modulus(key, key->rr);
+	}
+}
+
+/**
+ * rsa_mont_key_get() - Get a key in its Montgomery form
+ *
+ * Keys are cached, so that verifying several signatures with the same key
+ * converts it only once. The cache lives in .bss, which U-Boot proper cannot
+ * write before relocation; @buf is filled in instead there. SPL verifies
+ * from board_init_r(), after its .bss is cleared, and always uses the cache.
+ *
+ * @prop:	Key properties
+ * @exponent:	Public exponent
+ * @buf:	Used if the key cannot be cached
+ * @return the converted key
+ */
+static const struct rsa_mont_key *
+rsa_mont_key_get(const struct key_prop *prop, uint64_t exponent,
+		 struct rsa_mont_key *buf)
+{
+	struct rsa_mont_key *key;
+	uint i;
+
+#ifndef USE_HOSTCC
+	if (!IS_ENABLED(CONFIG_SPL_BUILD) && !(gd->flags & GD_FLG_RELOC)) {
+		rsa_mont_key_init(buf, prop, exponent);
+		return buf;
+	}
+#endif
+
+	for (i = 0; i < RSA_KEY_CACHE_SIZE; i++) {
+		if (rsa_mont_key_matches(&rsa_key_cache[i], prop, exponent))
+			return &rsa_key_cache[i];
+	}
+
+	key = &rsa_key_cache[rsa_key_cache_next];
+	rsa_key_cache_next = (rsa_key_cache_next + 1) % RSA_KEY_CACHE_SIZE;
+	rsa_mont_key_init(key, prop, exponent);
+
+	return key;
 }
 
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
@@ -255,18 +446,17 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 #else
 	uint64_t tmp;
 #endif
-	struct rsa_public_key key;
-	int ret;
+	const struct rsa_mont_key *key;
+	struct rsa_mont_key buf;
+	uint64_t exponent;
 
 	if (!prop) {
 		debug("%s: Skipping invalid prop", __func__);
 		return -EBADF;
 	}
-	key.n0inv = prop->n0inv;
-	key.len = prop->num_bits;
 
 	if (!prop->public_exponent) {
-		key.exponent = RSA_DEFAULT_PUBEXP;
+		exponent = RSA_DEFAULT_PUBEXP;
 	} else {
 		/*
 		 * it seems fdt64_to_cpu() input param address must be 8-bytes
@@ -276,41 +466,29 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		 * workaround it this a tmp value.
 		 */
 		memcpy((void *)&tmp, prop->public_exponent, sizeof(uint64_t));
-		key.exponent = fdt64_to_cpu(tmp);
+		exponent = fdt64_to_cpu(tmp);
 	}
 
-	if (!key.len || !prop->modulus || !prop->rr) {
+	if (!prop->num_bits || !prop->modulus || !prop->rr) {
 		debug("%s: Missing RSA key info", __func__);
 		return -EFAULT;
 	}
 
 	/* Sanity check for stack size */
-	if (key.len > RSA_MAX_KEY_BITS || key.len < RSA_MIN_KEY_BITS) {
-		debug("RSA key bits %u outside allowed range %d..%d\n",
-		      key.len, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
+	if (prop->num_bits > RSA_MAX_KEY_BITS ||
+	    prop->num_bits < RSA_MIN_KEY_BITS || prop->num_bits % 32) {
+		debug("RSA key bits %u outside allowed range %d..%d or not whole words\n",
+		      prop->num_bits, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
 		return -EFAULT;
 	}
-	key.len /= sizeof(uint32_t) * 8;
-	uint32_t key1[key.len], key2[key.len];
-
-	key.modulus = key1;
-	key.rr = key2;
-	rsa_convert_big_endian(key.modulus, (uint32_t *)prop->modulus, key.len);
-	rsa_convert_big_endian(key.rr, (uint32_t *)prop->rr, key.len);
-	if (!key.modulus || !key.rr) {
-		debug("%s: Out of memory", __func__);
-		return -ENOMEM;
-	}
 
-	uint32_t buf[sig_len / sizeof(uint32_t)];
-
-	memcpy(buf, sig, sig_len);
-
-	ret = pow_mod(&key, buf);
-	if (ret)
-		return ret;
+	if (sig_len != prop->num_bits / 8) {
+		debug("%s: Signature length %u does not match key\n",
+		      __func__, sig_len);
+		return -EINVAL;
+	}
 
-	memcpy(out, buf, sig_len);
+	key = rsa_mont_key_get(prop, exponent, &buf);
 
-	return 0;
+	return pow_mod(key, sig, out);
 }
@@ -134,6 +134,23 @@ static char tftp_filename[MAX_LEN];
 static unsigned short tftp_block_size = TFTP_BLOCK_SIZE;
 static unsigned short tftp_block_size_option = TFTP_MTU_BLOCKSIZE;
 
+/*
+ * RFC 7440 windowsize: the server sends this many DATA packets before it
+ * waits for an ACK. Only used for downloads, 1 means lock-step.
+ */
+#ifdef CONFIG_TFTP_WINDOWSIZE
+#define TFTP_WINDOWSIZE CONFIG_TFTP_WINDOWSIZE
+#else
+#define TFTP_WINDOWSIZE 1
+#endif
+
+static unsigned short tftp_windowsize = 1;
+static unsigned short tftp_windowsize_option = TFTP_WINDOWSIZE;
+/* block number at which the current window must be acknowledged */
+static ulong tftp_next_ack;
+/* out-of-order packets seen since the last ACK sent because of a gap */
+static int tftp_window_stray;
+
 #ifdef CONFIG_MCAST_TFTP
 #include <malloc.h>
 #define MTFTP_BITMAPSIZE	0x1000
@@ -211,6 +228,7 @@ static void new_transfer(void)
 	tftp_prev_block = 0;
 	tftp_block_wrap = 0;
 	tftp_block_wrap_offset = 0;
+	tftp_window_stray = 0;
 #ifdef CONFIG_CMD_TFTPPUT
 	tftp_put_final_block_sent = 0;
 #endif
@@ -320,6 +338,10 @@ static void tftp_complete(void)
 		puts("\n\t ");	/* Line up with "Loading: " */
 		print_size(net_boot_file_size /
 			time_start * 1000, "/s");
+		printf(" (%lu ms", time_start);
+		if (tftp_windowsize > 1)
+			printf(", windowsize %d", tftp_windowsize);
+		puts(")");
 	}
 	puts("\ndone\n");
 	net_set_state(NETLOOP_SUCCESS);
@@ -372,6 +394,10 @@ static void tftp_send(void)
 		/* try for more effic. blk size */
 		pkt += sprintf((char *)pkt, "blksize%c%d%c",
 				0, tftp_block_size_option, 0);
+		/* ask for a window of blocks per ACK on downloads */
+		if (tftp_state == STATE_SEND_RRQ && tftp_windowsize_option > 1)
+			pkt += sprintf((char *)pkt, "windowsize%c%d%c",
+					0, tftp_windowsize_option, 0);
 #ifdef CONFIG_MCAST_TFTP
 		/* Check all preconditions before even trying the option */
 		if (!tftp_mcast_disabled) {
@@ -404,6 +430,9 @@ static void tftp_send(void)
 		s[0] = htons(TFTP_ACK);
 		s[1] = htons(tftp_cur_block);
 		pkt = (uchar *)(s + 2);
+		/* the server restarts its window after the block we ACK */
+		tftp_next_ack = (unsigned short)(tftp_cur_block +
+						 tftp_windowsize);
 #ifdef CONFIG_CMD_TFTPPUT
 		if (tftp_put_active) {
 			int toload = tftp_block_size;
@@ -445,6 +474,22 @@ static void tftp_send(void)
 			    tftp_remote_port, tftp_our_port, len);
 }
 
+/*
+ * A DATA packet arrived that does not follow the last block we stored.
+ * Either it is ahead of it (a packet of the window got lost) or it is a
+ * stale packet from a window the server already restarted. Re-ACK the last
+ * in-order block so the server resends from there, but only once per
+ * window's worth of stray packets so we do not flood it with ACKs.
+ */
+static void tftp_window_resync(ulong block)
+{
+	debug("TFTP: got block %lu, expected %lu\n", block,
+	      (ulong)(unsigned short)(tftp_prev_block + 1));
+
+	if (tftp_window_stray++ % tftp_windowsize == 0)
+		tftp_send();
+}
+
 #ifdef CONFIG_CMD_TFTPPUT
 static void icmp_handler(unsigned type, unsigned code, unsigned dest,
 			 struct in_addr sip, unsigned src, uchar *pkt,
@@ -463,6 +508,7 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 	__be16 proto;
 	__be16 *s;
 	int i;
+	int ack;
 
 	if (dest != tftp_our_port) {
 #ifdef CONFIG_MCAST_TFTP
@@ -533,6 +579,16 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		 * something like "len-8" may give a *huge* number
 		 */
 		for (i = 0; i+8 < len; i++) {
+			if (!tftp_put_active && i + 11 < len &&
+			    strcmp((char *)pkt + i, "windowsize") == 0) {
+				tftp_windowsize = (unsigned short)
+					simple_strtoul((char *)pkt + i + 11,
+						       NULL, 10);
+				if (!tftp_windowsize)
+					tftp_windowsize = 1;
+				debug("Windowsize ack: %s, %d\n",
+				      (char *)pkt + i + 11, tftp_windowsize);
+			}
 			if (strcmp((char *)pkt + i, "blksize") == 0) {
 				tftp_block_size = (unsigned short)
 					simple_strtoul((char *)pkt + i + 8,
@@ -551,6 +607,9 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		}
 #ifdef CONFIG_MCAST_TFTP
 		parse_multicast_oack((char *)pkt, len - 1);
+		/* the multicast master client picks its own ACK numbers */
+		if (tftp_mcast_active)
+			tftp_windowsize = 1;
 		if ((tftp_mcast_active) && (!tftp_mcast_master_client))
 			tftp_state = STATE_DATA;	/* passive.. */
 		else
@@ -568,6 +627,18 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		if (len < 2)
 			return;
 		len -= 2;
+
+		/*
+		 * With a window in flight only the block right after the
+		 * last stored one is accepted, anything else means a loss.
+		 */
+		if (tftp_windowsize > 1 && tftp_state == STATE_DATA &&
+		    ntohs(*(__be16 *)pkt) !=
+		    (unsigned short)(tftp_prev_block + 1)) {
+			tftp_window_resync(ntohs(*(__be16 *)pkt));
+			break;
+		}
+
 		tftp_cur_block = ntohs(*(__be16 *)pkt);
 
 		update_block_number();
@@ -607,11 +678,15 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		net_set_timeout_handler(timeout_ms, tftp_timeout_handler);
 
 		store_block(tftp_cur_block - 1, pkt + 2, len);
+		tftp_window_stray = 0;
 
 		/*
 		 *	Acknowledge the block just received, which will prompt
-		 *	the remote for the next one.
+		 *	the remote for the next one. With a window only its
+		 *	last block and the final short block are ACKed.
 		 */
+		ack = tftp_cur_block == tftp_next_ack ||
+		      len < tftp_block_size;
 #ifdef CONFIG_MCAST_TFTP
 		/* if I am the MasterClient, actively calculate what my next
 		 * needed block is; else I'm passive; not ACKING
@@ -636,9 +711,11 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 				}
 				tftp_prev_block = tftp_cur_block;
 			}
+			ack = 1;
 		}
 #endif
-		tftp_send();
+		if (ack)
+			tftp_send();
 
 #ifdef CONFIG_MCAST_TFTP
 		if (tftp_mcast_active) {
@@ -710,6 +787,10 @@ void tftp_start(enum proto_t protocol)
 	if (ep != NULL)
 		tftp_block_size_option = simple_strtol(ep, NULL, 10);
 
+	ep = env_get("tftpwindowsize");
+	if (ep != NULL)
+		tftp_windowsize_option = simple_strtol(ep, NULL, 10);
+
 	ep = env_get("tftptimeout");
 	if (ep != NULL)
 		timeout_ms = simple_strtol(ep, NULL, 10);
@@ -837,6 +918,9 @@ void tftp_start(enum proto_t protocol)
 	memset(net_server_ethaddr, 0, 6);
 	/* Revert tftp_block_size to dflt */
 	tftp_block_size = TFTP_BLOCK_SIZE;
+	/* Lock-step until the server accepts a window in its OACK */
+	tftp_windowsize = 1;
+	tftp_next_ack = 1;
 #ifdef CONFIG_MCAST_TFTP
 	mcast_cleanup();
 #endif
@@ -866,6 +950,7 @@ void tftp_start_server(void)
 
 	/* Revert tftp_block_size to dflt */
 	tftp_block_size = TFTP_BLOCK_SIZE;
+	tftp_windowsize = 1;
 	tftp_cur_block = 0;
 	tftp_our_port = WELL_KNOWN_PORT;
 
@@ -0,0 +1,370 @@
+/*
+ * Test and benchmark of the software RSA modular exponentiation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <u-boot/rsa-mod-exp.h>
+
+/* Time spent on each key size by the benchmark, in milliseconds */
+#define RSA_BENCH_MS	1000
+
+/*
+ * Test keys with public exponent 65537: modulus, R^2 mod modulus, an input
+ * value and the expected input^65537 mod modulus, all big endian.
+ */
+/* 2048-bit key */
+static const uint8_t rsa2048_modulus[] = {
+	0xd6, 0xf6, 0x15, 0x79, 0x06, 0x4c, 0xab, 0x5f, 0x05, 0x0f, 0x7e, 0x05,
+	0xaf, 0x31, 0xf8, 0xf2, 0x0b, 0x31, 0xbc, 0xa2, 0xf2, 0x39, 0x79, 0x09,
+	0x15, 0xaa, 0x24, 0x6b, 0xd5, 0x84, 0x44, 0xbe, 0xd3, 0xba, 0x4c, 0x49,
+	0x09, 0x6e, 0x30, 0xbe, 0x66, 0x92, 0xa4, 0xd0, 0x56, 0xbc, 0xdd, 0xf9,
+	0x0d, 0xca, 0x13, 0xbb, 0x2d, 0x26, 0x96, 0x7f, 0x79, 0xae, 0x46, 0x32,
+	0x91, 0x93, 0x9c, 0xc3, 0x3f, 0x6b, 0x8d, 0xf9, 0x4c, 0xb1, 0xda, 0x24,
+	0x26, 0xc1, 0xd9, 0x39, 0xc0, 0xa6, 0xc8, 0x7d, 0x68, 0x52, 0xb6, 0x63,
+	0xed, 0xf8, 0x91, 0x24, 0x62, 0x32, 0x01, 0x57, 0x29, 0xc0, 0x07, 0x12,
+	0x6e, 0x35, 0x0a, 0xf5, 0xf3, 0xc2, 0xa8, 0x5f, 0xd3, 0xe9, 0x62, 0x77,
+	0xa6, 0xe0, 0xa9, 0x34, 0x50, 0x35, 0xc4, 0x2f, 0x57, 0xe0, 0x26, 0x48,
+	0x87, 0x22, 0xbd, 0x81, 0x80, 0xb2, 0xb3, 0x7f, 0x65, 0xde, 0xc5, 0xd4,
+	0xf7, 0xe0, 0x64, 0xdb, 0x1b, 0x74, 0x3d, 0xf4, 0x50, 0xcd, 0x57, 0x7a,
+	0x8c, 0x67, 0xc6, 0xc8, 0xe1, 0x76, 0xa4, 0xcb, 0xe9, 0xa8, 0x1d, 0x25,
+	0x0c, 0x59, 0x6a, 0x7e, 0xb4, 0x95, 0xd3, 0x3a, 0xb4, 0x68, 0x73, 0x68,
+	0x1e, 0x4d, 0xa3, 0x89, 0x7b, 0x0b, 0x78, 0x42, 0x2b, 0x47, 0x83, 0x6a,
+	0x8b, 0x0a, 0x66, 0xb7, 0xca, 0x96, 0x0b, 0x13, 0xcd, 0xbd, 0x37, 0x98,
+	0x12, 0xb9, 0x5a, 0xb1, 0x42, 0xc7, 0x04, 0xeb, 0xda, 0xd5, 0x76, 0x2e,
+	0x90, 0x86, 0x43, 0x2e, 0xaa, 0xcc, 0x19, 0x16, 0xae, 0x66, 0xa9, 0x46,
+	0x70, 0xd7, 0xd6, 0x28, 0xb7, 0x9a, 0x14, 0x08, 0xac, 0x89, 0x2a, 0x9d,
+	0x85, 0xba, 0x04, 0xa9, 0xab, 0x14, 0xfe, 0x12, 0xfe, 0xef, 0xbd, 0x2c,
+	0xcf, 0x64, 0x20, 0xc5, 0xd1, 0xa1, 0x9f, 0x2a, 0x1a, 0xee, 0x77, 0x21,
+	0xc4, 0x6c, 0x9c, 0xc9,
+};
+
+static const uint8_t rsa2048_rr[] = {
+	0x08, 0x34, 0xfe, 0x67, 0xe4, 0x5d, 0x77, 0xd7, 0x74, 0x0f, 0xfb, 0x0a,
+	0x69, 0x98, 0x39, 0xc8, 0x50, 0xcb, 0xa5, 0xea, 0x0b, 0xf9, 0x61, 0x3e,
+	0x38, 0xd4, 0xd2, 0x49, 0x52, 0x07, 0x52, 0x00, 0xe6, 0xcd, 0xb1, 0xfc,
+	0x82, 0x68, 0x90, 0x2e, 0xba, 0x0c, 0x74, 0xab, 0x92, 0xbc, 0x57, 0xe0,
+	0x74, 0xf1, 0x18, 0x37, 0x69, 0xb0, 0x56, 0x28, 0x24, 0x61, 0x13, 0x6b,
+	0xce, 0xb3, 0x58, 0xba, 0xcd, 0x7b, 0xd5, 0xf6, 0xd8, 0xa3, 0x8a, 0x7c,
+	0xb4, 0x51, 0x69, 0xd0, 0xae, 0x97, 0x80, 0x3b, 0x4d, 0xb8, 0x05, 0x8d,
+	0xe3, 0x90, 0xf8, 0x5e, 0x62, 0x3e, 0x12, 0x2d, 0xa9, 0x15, 0x07, 0x46,
+	0x76, 0x8c, 0xa9, 0xaa, 0x87, 0xb8, 0x18, 0x6d, 0x8d, 0xc9, 0x05, 0xf7,
+	0xfc, 0xfb, 0xf1, 0x2f, 0x2e, 0xab, 0x77, 0xc6, 0x5d, 0x4b, 0x6d, 0xfc,
+	0x95, 0xb4, 0xcf, 0xad, 0x03, 0xb0, 0x6f, 0x1d, 0x94, 0x48, 0x29, 0xc2,
+	0x9a, 0xa3, 0xfc, 0xe7, 0xce, 0x12, 0x96, 0xff, 0xa5, 0x95, 0xd8, 0x13,
+	0xb0, 0x75, 0x51, 0x16, 0xa1, 0xad, 0xe2, 0xab, 0x17, 0xe9, 0x5c, 0x31,
+	0x75, 0x85, 0xad, 0x51, 0x67, 0x83, 0x9f, 0x97, 0xf3, 0xd9, 0xa4, 0x20,
+	0x62, 0x03, 0x23, 0x1d, 0x63, 0x34, 0xbb, 0xce, 0x99, 0x09, 0x93, 0x9b,
+	0x20, 0xd3, 0x30, 0x64, 0x3a, 0xe3, 0xf0, 0x0d, 0x0f, 0xb0, 0x86, 0xb0,
+	0xf3, 0x06, 0x24, 0x8d, 0x85, 0x93, 0x4a, 0x7d, 0xc7, 0xcb, 0xaa, 0x19,
+	0xca, 0xa6, 0xd3, 0x5f, 0x14, 0x23, 0xed, 0x3e, 0x08, 0x5d, 0x0d, 0x1d,
+	0xf4, 0x40, 0x64, 0x02, 0x61, 0x67, 0x82, 0x63, 0xfc, 0xfc, 0x4c, 0x1a,
+	0x78, 0xbd, 0x67, 0x16, 0x12, 0xb0, 0xcf, 0xc6, 0xe0, 0x8d, 0xfa, 0xa6,
+	0x02, 0xda, 0x22, 0x86, 0x4b, 0xfc, 0x53, 0x6a, 0xe9, 0xe9, 0xde, 0x29,
+	0xb9, 0xd6, 0x05, 0x6d,
+};
+
+static const uint8_t rsa2048_in[] = {
+	0x8e, 0x19, 0x08, 0x7e, 0x39, 0x22, 0x19, 0xc9, 0x4f, 0x60, 0x65, 0x18,
+	0x55, 0x42, 0x6b, 0xd8, 0xe3, 0xfd, 0x1e, 0x72, 0xe0, 0xb5, 0x72, 0x93,
+	0x0e, 0x4d, 0x5f, 0xa7, 0xb9, 0x18, 0x11, 0x46, 0xc3, 0x31, 0xb2, 0x9b,
+	0x73, 0x28, 0xcb, 0x86, 0xbc, 0xee, 0xf4, 0x4c, 0x7f, 0x00, 0x4c, 0x4a,
+	0x20, 0xe6, 0x45, 0xb0, 0x4b, 0x92, 0x70, 0xba, 0xd0, 0xae, 0x2a, 0xba,
+	0x67, 0xab, 0x78, 0xb7, 0x35, 0x55, 0x62, 0x8b, 0x47, 0x85, 0x35, 0x30,
+	0x0c, 0x08, 0x37, 0xd9, 0xd3, 0xa7, 0x36, 0x69, 0x6a, 0x50, 0x14, 0x58,
+	0xd5, 0x9b, 0x47, 0xd2, 0xfd, 0xe3, 0xaa, 0x07, 0xfb, 0x2f, 0xff, 0xab,
+	0x40, 0xde, 0xa3, 0x01, 0x10, 0x84, 0xb9, 0x97, 0x24, 0x33, 0xff, 0xf4,
+	0x70, 0x5a, 0x4e, 0x85, 0x29, 0x99, 0x6b, 0x49, 0x34, 0x50, 0x3e, 0x28,
+	0x09, 0x6c, 0x65, 0x9f, 0x04, 0x1b, 0x3f, 0xe4, 0x78, 0x52, 0x91, 0x20,
+	0x6f, 0xda, 0xcc, 0x93, 0x24, 0x8e, 0x3b, 0x4d, 0x65, 0x2c, 0x8d, 0xb4,
+	0x52, 0xce, 0xae, 0xad, 0x8b, 0xb9, 0xbc, 0xd5, 0x90, 0x38, 0x8c, 0x6b,
+	0x2b, 0xa1, 0x9c, 0x7f, 0x43, 0x9f, 0x84, 0x59, 0xee, 0x78, 0x1c, 0x9e,
+	0x96, 0xa1, 0x02, 0x5c, 0xad, 0xab, 0x61, 0xd1, 0x3b, 0x8c, 0x08, 0x5b,
+	0xe9, 0x0b, 0xa3, 0x6e, 0x3a, 0x74, 0x92, 0xee, 0x48, 0x1a, 0x29, 0x97,
+	0x1e, 0x26, 0xdd, 0x58, 0x6f, 0x22, 0xab, 0x99, 0xf5, 0x26, 0xce, 0xb9,
+	0x53, 0xd0, 0x12, 0xd0, 0x6a, 0x18, 0x9c, 0x90, 0x14, 0x67, 0xa9, 0xc9,
+	0xaa, 0x45, 0x46, 0xe0, 0x48, 0x73, 0xee, 0x08, 0x71, 0x74, 0x32, 0xc0,
+	0xcd, 0xcc, 0x95, 0xeb, 0x3f, 0x05, 0xb0, 0xa1, 0xaa, 0xde, 0x29, 0xd5,
+	0x3e, 0x69, 0x92, 0xad, 0x7a, 0xc3, 0x41, 0xd1, 0x3a, 0xad, 0xf9, 0x65,
+	0x2e, 0xf0, 0x19, 0x8a,
+};
+
+static const uint8_t rsa2048_out[] = {
+	0x57, 0x6c, 0x48, 0x34, 0x5a, 0x17, 0x4b, 0x8a, 0x6d, 0x77, 0x53, 0xde,
+	0xb0, 0xa5, 0x0d, 0x00, 0xf6, 0x56, 0x4d, 0xc6, 0x7f, 0xcf, 0x05, 0x2f,
+	0x85, 0x2f, 0xf1, 0xa2, 0x87, 0x18, 0x05, 0x8b, 0x75, 0xe5, 0xce, 0x99,
+	0xa4, 0x7a, 0xa2, 0x2e, 0x74, 0xca, 0xaf, 0xb9, 0x9f, 0xe2, 0x63, 0x1b,
+	0x74, 0xf5, 0xd5, 0xfa, 0x84, 0x4b, 0xe5, 0x97, 0xf0, 0x19, 0x2f, 0x36,
+	0xdd, 0xc8, 0x71, 0x9e, 0x5a, 0xa3, 0xeb, 0xa4, 0xd8, 0xd2, 0xd2, 0xcd,
+	0x0e, 0x02, 0x64, 0x5c, 0x80, 0xe9, 0x47, 0x3b, 0x8e, 0x9d, 0x25, 0x00,
+	0x4d, 0xcd, 0x67, 0x8f, 0xb4, 0x13, 0xcd, 0x25, 0x06, 0x21, 0x58, 0xd9,
+	0x16, 0x21, 0xfe, 0xa2, 0x36, 0x2e, 0x2c, 0x71, 0xe7, 0x15, 0xf9, 0x21,
+	0x28, 0x7b, 0x18, 0x95, 0x4f, 0xde, 0x77, 0xfb, 0x1b, 0xa4, 0x9b, 0xd5,
+	0xb7, 0x2e, 0x03, 0xdd, 0xf5, 0xc9, 0xce, 0x0d, 0x8b, 0x74, 0x15, 0xd6,
+	0x93, 0x8a, 0xcd, 0x50, 0x07, 0x9e, 0x63, 0x54, 0x42, 0x97, 0x2f, 0x08,
+	0xf9, 0x78, 0x77, 0x4f, 0xbf, 0x69, 0xf1, 0xfe, 0xa4, 0x53, 0x68, 0x59,
+	0x2a, 0x0f, 0x8b, 0x32, 0x66, 0xb6, 0x2f, 0x27, 0xc7, 0x62, 0xca, 0x25,
+	0xfc, 0x0b, 0xed, 0x08, 0x45, 0xbb, 0x36, 0xd0, 0x9f, 0x21, 0x32, 0x91,
+	0x77, 0x1a, 0xbd, 0x65, 0x66, 0x7d, 0x20, 0x44, 0xb1, 0x24, 0x80, 0xd4,
+	0xe2, 0x27, 0x8b, 0x3f, 0xac, 0xf5, 0xd8, 0xd3, 0x0c, 0x25, 0x40, 0xb7,
+	0x94, 0xd4, 0xc2, 0x73, 0xd5, 0xd0, 0x0f, 0xcc, 0xb2, 0x10, 0xfd, 0xbf,
+	0xad, 0x0f, 0x14, 0x2e, 0x3a, 0x8f, 0x1d, 0x67, 0xfb, 0xae, 0x4a, 0xd3,
+	0x75, 0x52, 0xdd, 0xc3, 0xdc, 0x10, 0xa7, 0x2b, 0x36, 0x51, 0xa1, 0x0e,
+	0x2c, 0x7d, 0x25, 0x08, 0x8f, 0x60, 0xad, 0x98, 0x87, 0xd0, 0x47, 0xc4,
+	0x6e, 0x56, 0x9f, 0x37,
+};
+
+/* 4096-bit key */
+static const uint8_t rsa4096_modulus[] = {
+	0xdf, 0x10, 0xa1, 0xfa, 0x8d, 0x66, 0xb1, 0xc8, 0xdd, 0x53, 0xd5, 0x82,
+	0xbb, 0x85, 0x0b, 0x03, 0x8b, 0x67, 0x7b, 0x68, 0x93, 0x5a, 0xd8, 0x15,
+	0xe2, 0x9d, 0xbf, 0x64, 0x4f, 0xa3, 0xff, 0x96, 0x9e, 0x88, 0xbf, 0x13,
+	0x52, 0xac, 0x94, 0x8b, 0xd6, 0x61, 0xbe, 0xf1, 0xa1, 0xff, 0x94, 0x97,
+	0x88, 0x14, 0x5c, 0xeb, 0xf3, 0x01, 0xd7, 0x29, 0xf1, 0xdb, 0x15, 0x49,
+	0xd6, 0x32, 0x20, 0x14, 0xdc, 0x63, 0x37, 0xbd, 0xc7, 0x30, 0xba, 0x4a,
+	0xf3, 0x01, 0x0c, 0x81, 0x51, 0xf8, 0x26, 0xc6, 0x22, 0xa6, 0x8c, 0x33,
+	0xbb, 0x16, 0xf1, 0xe4, 0x3d, 0x7d, 0x8e, 0xc5, 0x15, 0x9f, 0xad, 0xc9,
+	0xf4, 0x5d, 0x00, 0xab, 0xb7, 0x69, 0xba, 0xd0, 0x55, 0x7a, 0x12, 0x0a,
+	0x55, 0x8e, 0x34, 0x84, 0x92, 0x5b, 0x56, 0xc0, 0x51, 0x95, 0x73, 0x97,
+	0x95, 0x5b, 0x61, 0x8b, 0x33, 0x0e, 0x7f, 0xd8, 0xae, 0x22, 0xf4, 0xc6,
+	0xd0, 0x08, 0x5e, 0x1b, 0x3e, 0x68, 0x67, 0x27, 0xac, 0x2c, 0x90, 0x32,
+	0x0e, 0xd5, 0x7d, 0x32, 0x94, 0xaa, 0x33, 0xde, 0x00, 0x69, 0x27, 0xa5,
+	0x3e, 0x8a, 0x43, 0xe8, 0xdf, 0x28, 0x26, 0xa1, 0x05, 0xc4, 0xea, 0xb6,
+	0x5e, 0x0d, 0xa6, 0x6f, 0xb7, 0xb1, 0x7c, 0x50, 0x4e, 0xcd, 0x1e, 0x18,
+	0x7b, 0xc0, 0x70, 0x29, 0x18, 0x65, 0x19, 0x22, 0x87, 0x5e, 0xec, 0x98,
+	0x45, 0xc1, 0x86, 0xf2, 0x1f, 0x73, 0x59, 0x67, 0xa5, 0xa0, 0xef, 0x3d,
+	0xb9, 0xc2, 0x5c, 0x61, 0xad, 0x9d, 0x88, 0x64, 0x63, 0x8b, 0xb8, 0xa7,
+	0x6b, 0x32, 0xe1, 0xa1, 0x50, 0xc7, 0xbb, 0x3e, 0x02, 0xb5, 0x33, 0x8c,
+	0x28, 0x02, 0x1d, 0x25, 0x3d, 0x23, 0xd3, 0xc3, 0x9f, 0x15, 0x8a, 0x1a,
+	0xcf, 0xe2, 0x92, 0x63, 0x01, 0x91, 0x77, 0xb6, 0x40, 0x25, 0xfd, 0x1a,
+	0xc5, 0xfc, 0xe5, 0xb1, 0xa3, 0x46, 0x69, 0x2f, 0x83, 0x2c, 0x7a, 0xf7,
+	0xc3, 0x48, 0xb5, 0xb1, 0x6e, 0x8c, 0xfb, 0x30, 0x25, 0x0f, 0x2c, 0x75,
+	0xd1, 0x6d, 0x40, 0xa7, 0x5c, 0x37, 0x78, 0x82, 0x4f, 0x76, 0x4d, 0x68,
+	0x1a, 0x21, 0xaf, 0x4b, 0xe3, 0xea, 0x6d, 0x72, 0xb7, 0x2b, 0x23, 0x86,
+	0x8c, 0x5a, 0x07, 0x13, 0xbf, 0x4f, 0x4e, 0x58, 0x68, 0x01, 0x48, 0x88,
+	0xac, 0xdb, 0xce, 0x3a, 0x05, 0xd1, 0xa2, 0xfc, 0x46, 0xcb, 0xa6, 0x79,
+	0xb2, 0xcc, 0x9d, 0x9c, 0x2d, 0x04, 0x68, 0x57, 0x4f, 0x7a, 0x54, 0xe8,
+	0xaa, 0xf8, 0xf6, 0x9a, 0xbd, 0x82, 0x3d, 0xad, 0xc3, 0xc6, 0x3b, 0x79,
+	0x35, 0x41, 0xdd, 0x10, 0x08, 0x3a, 0xd7, 0x3d, 0x41, 0x4f, 0x12, 0xfb,
+	0x69, 0xb8, 0x30, 0x57, 0x1c, 0x5d, 0xb0, 0xf6, 0x65, 0x69, 0x1f, 0x23,
+	0xf1, 0x50, 0x89, 0xbe, 0x02, 0xea, 0x9d, 0x92, 0xbe, 0x3b, 0xd3, 0xbc,
+	0x5b, 0x69, 0x06, 0xf1, 0xd3, 0xe9, 0x6c, 0x23, 0xf5, 0x84, 0x36, 0x19,
+	0xdb, 0x02, 0x8d, 0xa9, 0x25, 0xb9, 0x6a, 0x71, 0xcd, 0xc0, 0xa1, 0x7d,
+	0xbc, 0xfd, 0xf5, 0x28, 0xaf, 0xe0, 0x78, 0x34, 0x33, 0x3e, 0xc6, 0xe6,
+	0x62, 0x1e, 0x6f, 0xfd, 0x94, 0xea, 0xb8, 0xa8, 0xda, 0xd0, 0x96, 0xb1,
+	0xe3, 0xd4, 0xe6, 0xd6, 0xf3, 0xaf, 0x28, 0x27, 0x30, 0xb3, 0x6f, 0x70,
+	0x8b, 0x79, 0xbc, 0x40, 0xaf, 0x36, 0x92, 0x98, 0x92, 0xb7, 0xd1, 0x88,
+	0x7a, 0x63, 0xce, 0x23, 0xe6, 0x1a, 0x60, 0x00, 0x17, 0x1c, 0x28, 0x7e,
+	0xd6, 0x42, 0xfe, 0xf1, 0x51, 0xd5, 0x71, 0x1a, 0x0c, 0x72, 0x85, 0xbe,
+	0x64, 0x37, 0x05, 0xa0, 0x7c, 0xa4, 0x78, 0x60, 0x03, 0xd1, 0x95, 0x91,
+	0x1f, 0xc4, 0x85, 0x52, 0x87, 0xda, 0xd9, 0x23, 0x8f, 0x57, 0x60, 0x38,
+	0xb1, 0x4d, 0x0d, 0x0e, 0x4c, 0x35, 0x3e, 0x4f,
+};
+
+static const uint8_t rsa4096_rr[] = {
+	0x1d, 0x5d, 0x15, 0x47, 0x6a, 0x98, 0x18, 0x61, 0x57, 0x83, 0xb8, 0x3c,
+	0x01, 0x0a, 0xa6, 0x78, 0x54, 0x73, 0xfa, 0xc8, 0x97, 0xeb, 0x9e, 0x7c,
+	0xc9, 0x17, 0x68, 0x8b, 0x82, 0x93, 0x34, 0xb5, 0x76, 0x2d, 0x22, 0x6e,
+	0x34, 0x79, 0x3e, 0x7b, 0xe7, 0xa0, 0x02, 0x29, 0xd3, 0x27, 0x58, 0x2e,
+	0xd1, 0x36, 0xdf, 0xb3, 0x49, 0x4c, 0xbe, 0x7f, 0x00, 0x91, 0x28, 0x07,
+	0x86, 0x08, 0xdd, 0x64, 0xde, 0x32, 0x7c, 0xf6, 0xff, 0x33, 0x30, 0x1e,
+	0x39, 0x79, 0x86, 0x6c, 0x8a, 0xc9, 0xda, 0xf5, 0xc0, 0x9c, 0x11, 0xad,
+	0x23, 0x52, 0x4b, 0x8a, 0xb2, 0xd7, 0x0a, 0x49, 0xfd, 0x70, 0xb7, 0xbe,
+	0xd5, 0xc5, 0xc6, 0x37, 0xc7, 0x27, 0x22, 0x9d, 0x8e, 0x66, 0x47, 0x23,
+	0xd1, 0x47, 0x8b, 0xac, 0x14, 0x35, 0xb2, 0x58, 0x54, 0x23, 0x70, 0x94,
+	0x53, 0x9a, 0xb8, 0x45, 0xb8, 0xe4, 0x25, 0x55, 0x11, 0x95, 0xb7, 0xc3,
+	0xfb, 0xe4, 0xf6, 0xcb, 0x3f, 0xfc, 0xd7, 0x3b, 0x7e, 0xe7, 0x76, 0x91,
+	0xf6, 0xb9, 0xac, 0x55, 0xcc, 0xcf, 0xf0, 0x6b, 0x8b, 0xae, 0xe5, 0x37,
+	0x2b, 0xe5, 0x22, 0x0e, 0x83, 0x8c, 0x59, 0x14, 0xef, 0x97, 0xd8, 0xe3,
+	0xc9, 0x89, 0xfe, 0x13, 0xc8, 0xf7, 0xb0, 0x83, 0x96, 0x9c, 0x1a, 0xa9,
+	0x86, 0x5b, 0x0a, 0x86, 0x5b, 0x29, 0xa2, 0x08, 0x1d, 0x43, 0x05, 0x0d,
+	0x68, 0x1f, 0x47, 0x97, 0xef, 0x22, 0xef, 0x96, 0xf0, 0x5b, 0x56, 0x53,
+	0x55, 0x2f, 0x02, 0x34, 0xf1, 0x3f, 0xae, 0x2f, 0x50, 0xc8, 0x18, 0xfc,
+	0x4d, 0x87, 0xc0, 0xa6, 0x3b, 0x19, 0x5b, 0xda, 0x91, 0x0d, 0x55, 0x1b,
+	0xd0, 0x8b, 0xd0, 0x97, 0x24, 0x43, 0x2a, 0x9c, 0x1a, 0x26, 0x1e, 0xd2,
+	0x22, 0x6b, 0xca, 0x98, 0xa1, 0xeb, 0xc0, 0x65, 0xdf, 0xf6, 0x47, 0x89,
+	0x45, 0xdd, 0xa2, 0x86, 0xa5, 0x0b, 0x15, 0xfb, 0x50, 0x10, 0x63, 0x37,
+	0xe8, 0x99, 0x37, 0x07, 0xd3, 0x40, 0x5a, 0xf2, 0x15, 0xaa, 0x11, 0x2a,
+	0x67, 0x6b, 0xad, 0x2e, 0xfc, 0x95, 0x80, 0x2f, 0x04, 0xfc, 0x2f, 0x32,
+	0xf7, 0x16, 0x82, 0x04, 0xb3, 0xfc, 0x1e, 0x88, 0x1d, 0xa1, 0xdf, 0xe6,
+	0xad, 0xae, 0xa3, 0x84, 0x5c, 0xa6, 0x3f, 0x4a, 0xe7, 0xa1, 0xae, 0xf0,
+	0xee, 0xd2, 0x91, 0xb5, 0x74, 0x2e, 0x8b, 0x2b, 0x75, 0x70, 0x3f, 0xa6,
+	0xc1, 0xb3, 0xec, 0x16, 0x98, 0x60, 0x5f, 0x06, 0x35, 0x6d, 0xe8, 0xb7,
+	0x31, 0xc8, 0xa5, 0x3f, 0x7c, 0x36, 0xf9, 0xf8, 0xc7, 0x68, 0xe3, 0x69,
+	0xbf, 0xd6, 0x59, 0x59, 0x4c, 0x53, 0x68, 0xa4, 0x9a, 0x70, 0x37, 0xc3,
+	0xe2, 0x7b, 0xa8, 0x6c, 0x27, 0xf5, 0x3c, 0x0a, 0x56, 0x53, 0x3a, 0x39,
+	0x48, 0xc3, 0xf3, 0xca, 0x80, 0xed, 0x40, 0x00, 0xab, 0x91, 0x70, 0x3e,
+	0xc2, 0xae, 0x99, 0x0b, 0x3a, 0xd5, 0x95, 0x55, 0x65, 0x50, 0x6f, 0x18,
+	0x40, 0xbe, 0xf6, 0x1f, 0x11, 0x5f, 0xf3, 0x39, 0xc5, 0x0c, 0x97, 0x65,
+	0xa6, 0xec, 0x90, 0xd7, 0xc1, 0x8c, 0xcf, 0x91, 0x93, 0x24, 0xa5, 0xbe,
+	0x9d, 0x7d, 0xd1, 0xf0, 0xf2, 0xd5, 0x21, 0x13, 0x19, 0x56, 0x53, 0x58,
+	0x8d, 0xdd, 0xaf, 0x7f, 0x0e, 0x65, 0x1f, 0x13, 0x82, 0xeb, 0xdd, 0x87,
+	0x8b, 0x7b, 0x9e, 0xb8, 0xed, 0xcf, 0x2b, 0x13, 0xb6, 0xdb, 0x01, 0x74,
+	0xc0, 0x49, 0x7f, 0xf7, 0x1d, 0x38, 0xc0, 0x98, 0xde, 0x95, 0x96, 0xb6,
+	0xf7, 0x47, 0x0a, 0xeb, 0x35, 0x62, 0x8b, 0xe4, 0x3d, 0x7b, 0xe0, 0x91,
+	0xfd, 0x81, 0x5b, 0x34, 0x5d, 0x6a, 0xbb, 0x5d, 0xeb, 0x13, 0xf1, 0x37,
+	0x90, 0x72, 0x8e, 0xbd, 0xc9, 0x8e, 0x2e, 0xd4, 0xdd, 0x1b, 0x5a, 0xb1,
+	0x01, 0xc3, 0xd7, 0x1f, 0x4e, 0xd4, 0xf8, 0x3b,
+};
+
+static const uint8_t rsa4096_in[] = {
+	0x32, 0x94, 0xe5, 0x1e, 0x30, 0x57, 0xfb, 0xce, 0xdd, 0x61, 0xc6, 0x75,
+	0xf9, 0x5e, 0x88, 0xaa, 0x69, 0xa2, 0x7b, 0x84, 0x2b, 0x15, 0x6f, 0x90,
+	0x8e, 0xd7, 0xe3, 0x94, 0xc4, 0x99, 0x53, 0x0f, 0xe0, 0xd3, 0xec, 0x43,
+	0x1f, 0x29, 0x8c, 0x53, 0xe9, 0xf8, 0xb0, 0xa0, 0xe8, 0xc3, 0xbd, 0xc1,
+	0xd5, 0x0c, 0xff, 0xa0, 0x7f, 0x12, 0x55, 0xf4, 0xe5, 0x73, 0x13, 0xec,
+	0x72, 0xe7, 0xf2, 0xd7, 0x34, 0xca, 0x3b, 0xf7, 0xfa, 0x72, 0xcc, 0x34,
+	0xe3, 0xc5, 0x51, 0x61, 0x96, 0xba, 0x53, 0xd8, 0xac, 0xf3, 0x13, 0xac,
+	0x94, 0xd0, 0xa2, 0x27, 0xad, 0xc4, 0x5e, 0x9d, 0xed, 0x03, 0x6a, 0x04,
+	0x16, 0x71, 0x42, 0xe9, 0xa2, 0x7a, 0xf9, 0x23, 0xb7, 0x30, 0xdc, 0xf0,
+	0xb8, 0x75, 0xf7, 0x53, 0x72, 0xf0, 0x63, 0x94, 0x2f, 0x8a, 0xd9, 0x1a,
+	0xe3, 0xc3, 0xfd, 0x1a, 0x8e, 0x27, 0xfa, 0xab, 0x4e, 0x9b, 0xa1, 0xb0,
+	0x64, 0xdd, 0x7e, 0x73, 0x08, 0x5c, 0x91, 0x4d, 0x3b, 0xa5, 0xac, 0xef,
+	0x92, 0x59, 0x10, 0x62, 0xba, 0x5a, 0xfb, 0x80, 0x6d, 0x4b, 0xb1, 0xe7,
+	0x5a, 0x20, 0x69, 0x13, 0xf5, 0xc6, 0x78, 0x1f, 0x95, 0xa2, 0x7a, 0xb3,
+	0x32, 0x51, 0x46, 0xa2, 0x37, 0x84, 0xb9, 0xe4, 0xa8, 0x2b, 0x83, 0x66,
+	0x14, 0xf3, 0x30, 0x0b, 0x00, 0xaa, 0xce, 0x76, 0xe5, 0xef, 0xd3, 0xc1,
+	0xa1, 0xe5, 0x6d, 0x9c, 0xb4, 0x5c, 0xa1, 0x3d, 0x42, 0xe8, 0xe9, 0x24,
+	0x16, 0x7b, 0x62, 0x68, 0xce, 0x8e, 0xdc, 0x49, 0x59, 0x0b, 0x81, 0xf0,
+	0x9b, 0x96, 0xa7, 0xbf, 0x4f, 0xa2, 0x7d, 0x32, 0x98, 0x3e, 0x8a, 0x5f,
+	0x2c, 0xf6, 0x5c, 0x2c, 0xf4, 0x75, 0x9e, 0xe8, 0x53, 0xa0, 0xae, 0xde,
+	0x8e, 0x20, 0x64, 0x75, 0xe4, 0x77, 0xca, 0xaf, 0x1e, 0x6e, 0xd8, 0xe0,
+	0xbe, 0x58, 0xdd, 0x6f, 0x38, 0xa4, 0x6a, 0xf9, 0xf8, 0xbc, 0x60, 0x4c,
+	0xdb, 0x5c, 0x8f, 0xd0, 0x11, 0x13, 0xe4, 0x7b, 0xae, 0xe6, 0xd0, 0x1e,
+	0x32, 0xb6, 0xa3, 0x06, 0x31, 0x7a, 0x4a, 0x68, 0x05, 0xa9, 0xa6, 0xad,
+	0x3f, 0x44, 0xe9, 0x84, 0x3e, 0x12, 0xac, 0x58, 0x5c, 0xf1, 0x93, 0x41,
+	0x41, 0x98, 0x3a, 0x4d, 0xa9, 0xc4, 0x33, 0xf2, 0xdb, 0x2a, 0x2f, 0xb9,
+	0xcb, 0xb6, 0x37, 0x9a, 0x4e, 0x3f, 0x1f, 0x06, 0x45, 0x42, 0xe4, 0x81,
+	0x7d, 0xad, 0x1d, 0xd1, 0x53, 0xdc, 0x0f, 0xd7, 0x38, 0xa6, 0xf8, 0x59,
+	0xa6, 0x9e, 0xc4, 0x4d, 0xfe, 0x8b, 0x75, 0x4e, 0xa1, 0x53, 0x84, 0x93,
+	0x50, 0x32, 0x30, 0x82, 0xae, 0x3f, 0x5b, 0x72, 0x96, 0x10, 0x13, 0xd6,
+	0x26, 0x17, 0x41, 0x18, 0xb7, 0xd0, 0xc4, 0x5a, 0xe1, 0xb2, 0x6b, 0xa5,
+	0x59, 0x5d, 0x8e, 0x4b, 0x33, 0x7d, 0x28, 0x24, 0xa8, 0x53, 0x61, 0x78,
+	0x90, 0x84, 0x32, 0x4f, 0x02, 0x20, 0x7b, 0x0f, 0xb8, 0x85, 0x85, 0x4a,
+	0x2f, 0x53, 0x51, 0xcf, 0x10, 0x5a, 0x14, 0x5d, 0x81, 0x98, 0x34, 0x23,
+	0xe4, 0xa0, 0xad, 0xab, 0x21, 0x05, 0xc4, 0xf3, 0xa6, 0x99, 0x1b, 0x42,
+	0xc7, 0x1e, 0xd3, 0x20, 0x3a, 0x47, 0xd9, 0xff, 0x38, 0xd4, 0x4c, 0x84,
+	0xe1, 0x8a, 0xbf, 0xbe, 0xbb, 0x67, 0x59, 0xaf, 0x28, 0x7f, 0xe8, 0xff,
+	0x2b, 0x3c, 0xe4, 0xe3, 0xa5, 0x6d, 0x07, 0x30, 0xf6, 0xd8, 0xcf, 0x5a,
+	0x87, 0xf5, 0x0e, 0x41, 0x8f, 0x22, 0xc8, 0xa0, 0xb4, 0xa3, 0xcb, 0x6e,
+	0x77, 0xb9, 0x07, 0xa3, 0x0b, 0xb0, 0x0a, 0xcd, 0x5e, 0xd3, 0xbc, 0xc1,
+	0xa4, 0xf3, 0xb6, 0xcb, 0xa2, 0xe1, 0xcb, 0x07, 0x45, 0xab, 0xf8, 0xda,
+	0x3d, 0x4c, 0x6e, 0x07, 0x4c, 0xd4, 0xcc, 0xee, 0x5a, 0xf1, 0xd2, 0xe8,
+	0xf7, 0xd2, 0xf7, 0x72, 0x49, 0xa5, 0xa1, 0x0b,
+};
+
+static const uint8_t rsa4096_out[] = {
+	0x1b, 0xb4, 0x5b, 0x3e, 0xd0, 0xa5, 0x2c, 0xe8, 0x3a, 0xb2, 0x87, 0x2d,
+	0xe7, 0x53, 0x12, 0xec, 0x10, 0xe0, 0x7c, 0x05, 0xcc, 0x48, 0x26, 0x8b,
+	0xa3, 0x0a, 0x9c, 0xe1, 0xd0, 0x40, 0x01, 0xa2, 0xa8, 0x7a, 0x77, 0xe0,
+	0xa6, 0x4e, 0x57, 0x17, 0xa8, 0x43, 0x10, 0x56, 0xd2, 0x93, 0xab, 0x81,
+	0x71, 0xbe, 0x1e, 0x24, 0xa5, 0x13, 0x39, 0x73, 0x1e, 0xc9, 0xfa, 0x9f,
+	0x1e, 0xcb, 0x12, 0xbb, 0x14, 0xea, 0x92, 0xf7, 0x60, 0x68, 0xbb, 0x6e,
+	0x54, 0x27, 0x47, 0xf7, 0x6d, 0x7b, 0xe4, 0x74, 0x09, 0xe5, 0xa7, 0x1e,
+	0x88, 0x36, 0xcc, 0xc0, 0xf2, 0xf6, 0xae, 0xe1, 0x17, 0xa3, 0xdd, 0x70,
+	0x67, 0xe3, 0x05, 0xce, 0x1d, 0x61, 0xfc, 0x7c, 0xf6, 0xff, 0x53, 0x9f,
+	0xba, 0xd6, 0x92, 0xaa, 0xf8, 0x5c, 0x05, 0x47, 0x12, 0xef, 0x0e, 0x99,
+	0xce, 0x94, 0x50, 0xcc, 0x0d, 0x3d, 0x3a, 0x8a, 0x82, 0xd1, 0xb4, 0xd0,
+	0x68, 0x33, 0x4e, 0xb9, 0x14, 0x95, 0x6b, 0x7e, 0x76, 0xa4, 0xe6, 0xe3,
+	0xf3, 0x60, 0x67, 0x9e, 0xa4, 0x26, 0xf9, 0xa4, 0x9e, 0x67, 0xb3, 0x95,
+	0xec, 0x4f, 0x7c, 0x68, 0xed, 0x57, 0x23, 0xbc, 0xd0, 0x90, 0xda, 0xfe,
+	0xaa, 0xec, 0xbb, 0x6e, 0x48, 0xd0, 0x3c, 0x25, 0x74, 0xdb, 0x6f, 0x54,
+	0x80, 0xe1, 0x63, 0xb4, 0xcf, 0xbf, 0x21, 0x14, 0xce, 0x48, 0x54, 0x03,
+	0xe0, 0x5c, 0xef, 0x28, 0xaf, 0xf0, 0x6d, 0xa3, 0x20, 0x9b, 0xb9, 0x22,
+	0xc1, 0x99, 0x11, 0xe9, 0x4b, 0xa3, 0x45, 0xf9, 0x23, 0x5b, 0x75, 0x42,
+	0xff, 0x7f, 0xd0, 0x75, 0x6e, 0x06, 0x25, 0x61, 0x86, 0x54, 0x3e, 0x32,
+	0x4a, 0x98, 0x55, 0x51, 0x61, 0xa5, 0xe4, 0x68, 0xb2, 0x94, 0x28, 0x03,
+	0x17, 0xb1, 0x17, 0x64, 0x82, 0x96, 0x7c, 0x25, 0x5e, 0x90, 0x3b, 0xd4,
+	0x81, 0xb7, 0xd4, 0x66, 0x8a, 0xee, 0x59, 0xf2, 0xf3, 0x82, 0x06, 0x58,
+	0x3c, 0x02, 0x58, 0xb2, 0x88, 0x93, 0xc5, 0xee, 0xa6, 0xc0, 0xb6, 0x7d,
+	0xaf, 0x03, 0xaf, 0x2a, 0x88, 0x8f, 0xf2, 0xd4, 0xd5, 0xb6, 0x88, 0x62,
+	0xad, 0x9e, 0x5c, 0x0e, 0x16, 0x62, 0x4a, 0x42, 0x86, 0x01, 0x9b, 0xd9,
+	0xd9, 0x25, 0x7a, 0x6e, 0xff, 0xef, 0xe1, 0xc8, 0x7b, 0x06, 0x65, 0xc3,
+	0xf0, 0x75, 0x2e, 0x93, 0xcd, 0xa9, 0xda, 0x43, 0x33, 0x1f, 0x1c, 0xd6,
+	0x55, 0x45, 0xbf, 0xba, 0xde, 0x2a, 0x1d, 0x76, 0x53, 0xb8, 0x09, 0x16,
+	0x42, 0xa8, 0x4d, 0x02, 0xaa, 0x32, 0xc9, 0xf7, 0x6c, 0xf3, 0x5b, 0x87,
+	0x18, 0x61, 0xea, 0x44, 0x76, 0x51, 0xc1, 0x37, 0xd8, 0x77, 0x1e, 0x4d,
+	0xc1, 0xba, 0xc5, 0xa4, 0xd4, 0x81, 0x86, 0x5e, 0x10, 0xe9, 0x34, 0x55,
+	0x62, 0x5f, 0x08, 0xba, 0x5b, 0xc0, 0x28, 0x0f, 0x3a, 0xcd, 0x29, 0x4b,
+	0x8a, 0xf0, 0x4b, 0xe3, 0x55, 0xdb, 0xd4, 0xdc, 0xfa, 0xa7, 0xfc, 0x1d,
+	0x7e, 0xe6, 0x6a, 0x1d, 0xf1, 0x27, 0x77, 0xd9, 0x16, 0x74, 0xd8, 0xcf,
+	0x2f, 0xf6, 0xf0, 0x95, 0x26, 0x56, 0x18, 0x75, 0x47, 0x08, 0xb0, 0xe9,
+	0xbe, 0x45, 0x7f, 0x37, 0xef, 0x5a, 0xb5, 0x15, 0x95, 0x29, 0x9b, 0xc4,
+	0x3b, 0x3e, 0x1a, 0xfd, 0x5b, 0x63, 0x3c, 0x4a, 0x6f, 0x5a, 0xd2, 0xd8,
+	0xf6, 0x43, 0x17, 0x36, 0xa7, 0x91, 0xeb, 0x69, 0x6d, 0x64, 0x29, 0x59,
+	0x40, 0xb8, 0x4d, 0xd9, 0x4d, 0x0c, 0x18, 0x83, 0x96, 0xa4, 0x80, 0xcb,
+	0xff, 0xcb, 0x6d, 0x75, 0x0e, 0x34, 0x73, 0x63, 0xc7, 0x84, 0x97, 0xb3,
+	0x7b, 0x1c, 0xab, 0x6d, 0xea, 0x53, 0x67, 0xc3, 0x93, 0x0e, 0x34, 0xfc,
+	0x2b, 0x1e, 0x79, 0x9e, 0x75, 0x50, 0x71, 0xfb, 0xd8, 0xbe, 0xec, 0x94,
+	0x13, 0x38, 0x56, 0xcd, 0x08, 0xc9, 0xd2, 0xf7,
+};
+
+struct rsa_test_key {
+	int num_bits;
+	const uint8_t *modulus;
+	const uint8_t *rr;
+	const uint8_t *in;
+	const uint8_t *out;
+};
+
+static const struct rsa_test_key rsa_test_keys[] = {
+	{ 2048, rsa2048_modulus, rsa2048_rr, rsa2048_in, rsa2048_out },
+	{ 4096, rsa4096_modulus, rsa4096_rr, rsa4096_in, rsa4096_out },
+};
+
+static int test_rsa_mod_exp(const struct rsa_test_key *tk)
+{
+	uint32_t len = tk->num_bits / 8;
+	struct key_prop prop;
+	uint8_t out[len];
+	ulong start, delta;
+	int iter, ret;
+
+	memset(&prop, 0, sizeof(prop));
+	prop.modulus = tk->modulus;
+	prop.rr = tk->rr;
+	prop.num_bits = tk->num_bits;
+
+	ret = rsa_mod_exp_sw(tk->in, len, &prop, out);
+	if (ret) {
+		printf("%s: %d-bit mod_exp failed, ret=%d\n",
+		       __func__, tk->num_bits, ret);
+		return ret;
+	}
+	if (memcmp(out, tk->out, len)) {
+		printf("%s: %d-bit mod_exp gave a wrong result\n",
+		       __func__, tk->num_bits);
+		return -EINVAL;
+	}
+
+	/* Same key again: served from the converted key cache */
+	start = get_timer(0);
+	iter = 0;
+	do {
+		ret = rsa_mod_exp_sw(tk->in, len, &prop, out);
+		if (ret)
+			return ret;
+		iter++;
+		delta = get_timer(start);
+	} while (delta < RSA_BENCH_MS);
+
+	printf("%s: %d-bit: %d verifies in %lu ms, %lu verifies/s\n",
+	       __func__, tk->num_bits, iter, delta, iter * 1000UL / delta);
+
+	return memcmp(out, tk->out, len) ? -EINVAL : 0;
+}
+
+int do_ut_rsa(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	int i, ret = 0;
+
+	for (i = 0; i < ARRAY_SIZE(rsa_test_keys); i++)
+		ret |= test_rsa_mod_exp(&rsa_test_keys[i]);
+
+	printf("Test %s\n", ret ? "failed" : "passed");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}